@@ -0,0 +1,151 @@
+module;
+#include <array>
+#include <cassert>
+
+export module RayTracer:Affine;
+
+import :FloatHelper;
+import :Matrix;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A transform made of only rotation, scaling, shearing and translation, stored as the top three rows of a 4x4
+	/// matrix. The bottom row of such a matrix is always 0, 0, 0, 1, so leaving it out saves a quarter of the memory
+	/// and the multiplications, and a point always stays a point and a vector a vector without fixing up W.\n
+	/// Transforms are still built as Matrix&lt;4&gt;, this is what they're converted to for the paths every ray goes
+	/// through.
+	/// </summary>
+	export struct Affine
+	{
+		static constexpr Affine Identity() { return {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0}; }
+
+		/// <summary>
+		/// Drops the bottom row of the matrix, which must be 0, 0, 0, 1.
+		/// </summary>
+		static Affine From(const Matrix<4>& matrix)
+		{
+			assert(matrix(3, 0) == 0 && matrix(3, 1) == 0 && matrix(3, 2) == 0 && matrix(3, 3) == 1);
+
+			// Rows are stored in the same order as Matrix, so the values are simply the first twelve.
+			Affine affine{};
+			for (int i = 0; i < 12; ++i) { affine.Values[i] = matrix.Values[i]; }
+
+			return affine;
+		}
+
+		// Row major, each row being three linear terms followed by the translation.
+		std::array<float, 12> Values;
+
+		constexpr float& operator()(size_t row, size_t column) { return Values[4 * row + column]; }
+
+		constexpr const float& operator()(size_t row, size_t column) const { return Values[4 * row + column]; }
+
+		Matrix<4> ToMatrix() const
+		{
+			Matrix<4> matrix = Matrix<4>::IdentityMatrix();
+			for (int i = 0; i < 12; ++i) { matrix.Values[i] = Values[i]; }
+
+			return matrix;
+		}
+
+		/// <returns>The point moved by the whole transform, including translation.</returns>
+		constexpr Tuple TransformPoint(const Tuple& point) const
+		{
+			return Tuple::Point
+			(
+				Values[0] * point.X + Values[1] * point.Y + Values[2] * point.Z + Values[3],
+				Values[4] * point.X + Values[5] * point.Y + Values[6] * point.Z + Values[7],
+				Values[8] * point.X + Values[9] * point.Y + Values[10] * point.Z + Values[11]
+			);
+		}
+
+		/// <returns>The vector transformed by everything but translation, as a direction can't be moved.</returns>
+		constexpr Tuple TransformVector(const Tuple& vector) const
+		{
+			return Tuple::Vector
+			(
+				Values[0] * vector.X + Values[1] * vector.Y + Values[2] * vector.Z,
+				Values[4] * vector.X + Values[5] * vector.Y + Values[6] * vector.Z,
+				Values[8] * vector.X + Values[9] * vector.Y + Values[10] * vector.Z
+			);
+		}
+
+		/// <summary>
+		/// Multiplies the vector by the transpose of the linear part. Called on a shape's inverse transform this takes
+		/// a normal from object space to world space, keeping it perpendicular to the surface under scaling and
+		/// shearing. The result isn't normalised.
+		/// </summary>
+		constexpr Tuple TransformNormal(const Tuple& normal) const
+		{
+			return Tuple::Vector
+			(
+				Values[0] * normal.X + Values[4] * normal.Y + Values[8] * normal.Z,
+				Values[1] * normal.X + Values[5] * normal.Y + Values[9] * normal.Z,
+				Values[2] * normal.X + Values[6] * normal.Y + Values[10] * normal.Z
+			);
+		}
+
+		/// <returns>This transform applied after rhs.</returns>
+		constexpr Affine operator*(const Affine& rhs) const
+		{
+			Affine result{};
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 4; ++column)
+				{
+					float value = column == 3 ? (*this)(row, 3) : 0;
+					for (int i = 0; i < 3; ++i) { value += (*this)(row, i) * rhs(i, column); }
+					result(row, column) = value;
+				}
+			}
+
+			return result;
+		}
+
+		/// <summary>
+		/// Inverts the 3x3 linear part from its cofactors and undoes the translation with it, far less work than
+		/// inverting a general 4x4 matrix.
+		/// </summary>
+		Affine Inverted() const
+		{
+			const Affine& m = *this;
+
+			// Cofactors of the first column, reused for the determinant.
+			float c00 = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+			float c10 = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+			float c20 = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+
+			float determinant = m(0, 0) * c00 + m(0, 1) * c10 + m(0, 2) * c20;
+			float inverseDeterminant = 1.0f / determinant;
+
+			Affine inverted{};
+			inverted(0, 0) = c00 * inverseDeterminant;
+			inverted(1, 0) = c10 * inverseDeterminant;
+			inverted(2, 0) = c20 * inverseDeterminant;
+			inverted(0, 1) = (m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2)) * inverseDeterminant;
+			inverted(1, 1) = (m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0)) * inverseDeterminant;
+			inverted(2, 1) = (m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)) * inverseDeterminant;
+			inverted(0, 2) = (m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)) * inverseDeterminant;
+			inverted(1, 2) = (m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)) * inverseDeterminant;
+			inverted(2, 2) = (m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)) * inverseDeterminant;
+
+			for (int row = 0; row < 3; ++row)
+			{
+				inverted(row, 3) = -(inverted(row, 0) * m(0, 3) + inverted(row, 1) * m(1, 3) +
+					inverted(row, 2) * m(2, 3));
+			}
+
+			return inverted;
+		}
+
+		bool operator==(const Affine& rhs) const
+		{
+			bool isAlmostEqual = true;
+			for (int i = 0; i < 12; ++i) { isAlmostEqual &= AlmostEquals(Values[i], rhs.Values[i]); }
+
+			return isAlmostEqual;
+		}
+	};
+}
@@ -209,7 +209,7 @@ namespace RayTracer
 
 		const float& operator[](std::size_t index) const { return Values[index]; }
 
-		Matrix Transposed()
+		Matrix Transposed() const
 		{
 			Matrix transposed;
 			for (int row = 0; row < Dimensions; ++row)
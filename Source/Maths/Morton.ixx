@@ -0,0 +1,45 @@
+module;
+#include <cstdint>
+
+export module RayTracer:Morton;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Spreads the low 16 bits of value out to every other bit, leaving a gap for a second coordinate.
+	/// </summary>
+	export constexpr uint32_t SpreadBits2(uint32_t value)
+	{
+		value &= 0x0000ffff;
+		value = (value | (value << 8)) & 0x00ff00ff;
+		value = (value | (value << 4)) & 0x0f0f0f0f;
+		value = (value | (value << 2)) & 0x33333333;
+		value = (value | (value << 1)) & 0x55555555;
+		return value;
+	}
+
+	/// <summary>
+	/// Spreads the low 10 bits of value out to every third bit, leaving gaps for two more coordinates.
+	/// </summary>
+	export constexpr uint32_t SpreadBits3(uint32_t value)
+	{
+		value &= 0x000003ff;
+		value = (value | (value << 16)) & 0xff0000ff;
+		value = (value | (value << 8)) & 0x0300f00f;
+		value = (value | (value << 4)) & 0x030c30c3;
+		value = (value | (value << 2)) & 0x09249249;
+		return value;
+	}
+
+	/// <returns>
+	/// The position along a Z order curve of a 2D coordinate of up to 16 bits each. Coordinates that are close
+	/// together mostly end up close together along the curve.
+	/// </returns>
+	export constexpr uint32_t MortonCode(uint32_t x, uint32_t y) { return SpreadBits2(x) | SpreadBits2(y) << 1; }
+
+	/// <returns>The position along a Z order curve of a 3D coordinate of up to 10 bits each.</returns>
+	export constexpr uint32_t MortonCode(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return SpreadBits3(x) | SpreadBits3(y) << 1 | SpreadBits3(z) << 2;
+	}
+}
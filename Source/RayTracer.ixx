@@ -3,6 +3,7 @@ export module RayTracer;
 export import :Tuple;
 export import :Canvas;
 export import :Matrix;
+export import :Affine;
 export import :Shape;
 export import :Sphere;
 export import :Plane;
@@ -12,4 +13,27 @@ export import :Material;
 export import :World;
 export import :Camera;
 export import :FloatHelper;
-export import :Pattern;
\ No newline at end of file
+export import :Pattern;
+export import :Wavefront;
+export import :Scene;
+export import :Socket;
+export import :Distributed;
+export import :Bounds;
+export import :BVH;
+export import :ThreadPool;
+export import :Animation;
+export import :GBuffer;
+export import :Arena;
+export import :MaterialTable;
+export import :Shading;
+export import :Morton;
+export import :RenderSettings;
+export import :RenderStatistics;
+export import :Memory;
+export import :RenderJob;
+export import :Daemon;
+export import :MappedFile;
+export import :Checkpoint;
+export import :MultiProcess;
+export import :PostProcess;
+export import :Trace;
\ No newline at end of file
@@ -0,0 +1,98 @@
+module;
+#include <functional>
+#include <vector>
+
+export module RayTracer:Animation;
+
+import :Camera;
+import :Canvas;
+import :Matrix;
+import :Shape;
+import :ThreadPool;
+import :World;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Renders a sequence of frames of a world where objects, and optionally the camera, move over time.\n
+	/// Everything is kept between frames rather than set up from scratch for each. Only the animated objects are moved
+	/// for each frame, the acceleration structure is built once and then refitted around them without working out any
+	/// other object's bounds again, and every frame is rendered on the same thread pool.
+	/// </summary>
+	export class Animation
+	{
+	public:
+		/// <summary>
+		/// Gives a transform for a time in seconds from the start of the animation.
+		/// </summary>
+		using TransformFunction = std::function<Matrix<4>(float time)>;
+
+		/// <summary>
+		/// Called with each frame's number and image as soon as it's rendered.
+		/// </summary>
+		using FrameCallback = std::function<void(int frame, const Canvas& image)>;
+
+	private:
+		struct Track
+		{
+			Shape* Shape_;
+
+			TransformFunction Transform;
+		};
+
+		World& World_;
+
+		Camera& Camera_;
+
+		std::vector<Track> Tracks_;
+
+		// Every animated shape, for refitting around.
+		std::vector<Shape*> Moving_;
+
+		TransformFunction CameraTrack_;
+
+	public:
+		float FramesPerSecond = 24;
+
+		Animation(World& world, Camera& camera) : World_(world), Camera_(camera) {}
+
+		/// <summary>
+		/// Makes the object's transform a function of time. The object must belong to the world.
+		/// </summary>
+		void Animate(Shape& shape, TransformFunction transform)
+		{
+			Tracks_.push_back({&shape, std::move(transform)});
+			Moving_.push_back(&shape);
+		}
+
+		void AnimateCamera(TransformFunction transform) { CameraTrack_ = std::move(transform); }
+
+		/// <summary>
+		/// Moves everything animated to where it is at the time, in seconds, and refits the acceleration
+		/// structure around them.
+		/// </summary>
+		void SetTime(float time)
+		{
+			for (const Track& track : Tracks_) { track.Shape_->SetTransform(track.Transform(time)); }
+			if (CameraTrack_) { Camera_.Transform = CameraTrack_(time); }
+
+			if (World_.Acceleration.IsBuiltFor(World_.Objects)) { World_.RefitAccelerationStructure(Moving_); }
+			else { World_.BuildAccelerationStructure(); }
+		}
+
+		void SetFrame(int frame) { SetTime(static_cast<float>(frame) / FramesPerSecond); }
+
+		/// <summary>
+		/// Renders every frame from first to last inclusive, in order.
+		/// </summary>
+		void Render(int firstFrame, int lastFrame, const FrameCallback& onFrame,
+		            ThreadPool& threadPool = ThreadPool::Shared())
+		{
+			for (int frame = firstFrame; frame <= lastFrame; ++frame)
+			{
+				SetFrame(frame);
+				onFrame(frame, Camera_.Render(World_, threadPool));
+			}
+		}
+	};
+}
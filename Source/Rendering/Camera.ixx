@@ -1,10 +1,34 @@
 module;
+#include<algorithm>
+#include<atomic>
+#include<cassert>
+#include<chrono>
 #include<cmath>
+#include<fstream>
+#include<functional>
+#include<optional>
+#include<ostream>
+#include<span>
+#include<stdexcept>
+#include<string>
+#include<utility>
+#include<vector>
 export module RayTracer:Camera;
+import :Affine;
 import :Matrix;
+import :Memory;
 import :Ray;
+import :RenderJob;
+import :RenderSettings;
+import :RenderStatistics;
 import :Canvas;
+import :Checkpoint;
+import :Shape;
 import :World;
+import :Wavefront;
+import :ThreadPool;
+import :Trace;
+import :GBuffer;
 
 namespace RayTracer
 {
@@ -27,6 +51,13 @@ namespace RayTracer
 		// The size of the pixels on the canvas in world-space units.
 		float PixelSize;
 
+		// How far reflections are followed when rendering.
+		RenderSettings Settings;
+
+		// How the pixels of images rendered a tile at a time are laid out in memory. The tiled layouts keep each
+		// tile's pixels together, rather than spread across as many rows as the tile is high.
+		CanvasLayout Layout = CanvasLayout::Linear;
+
 		Camera(int width, int height, float fieldOfView, const Matrix<4>& transform) : RenderWidth(width),
 			RenderHeight(height), FieldOfView(fieldOfView), Transform(transform)
 		{
@@ -52,37 +83,568 @@ namespace RayTracer
 
 		Ray RayForPixel(int x, int y) const
 		{
-			// Offset from edge of canvas to pixel's centre.
-			float xOffset = x + 0.5;
-			float yOffset = y + 0.5;
+			Ray ray;
+			RaysForRow(GetBasis(), y, x, {&ray, 1});
+
+			return ray;
+		}
+
+		/// <summary>
+		/// Fills the buffer with the rays for consecutive pixels along a row, starting at firstX. Each pixel is a
+		/// fixed step along from the last, so this is only a few additions per ray, with the normalisation done as
+		/// a separate pass over a batch of rays that the compiler can vectorise.
+		/// </summary>
+		void RaysForRow(int y, int firstX, std::span<Ray> rays) const { RaysForRow(GetBasis(), y, firstX, rays); }
+
+		/// <returns>The whole image as a region.</returns>
+		Region GetRegion() const { return {0, 0, RenderWidth, RenderHeight}; }
+
+		// Width and height of the tiles a render is split into to share between threads.
+		static constexpr int TileSize = 16;
+
+		Canvas Render(const World& world) const { return Render(world, ThreadPool::Shared()); }
+
+		/// <summary>
+		/// Renders the whole image a tile at a time across the thread pool.
+		/// </summary>
+		Canvas Render(const World& world, ThreadPool& threadPool) const
+		{
+			// Brought up to date before any threads read it.
+			world.Prepare();
+
+			return RenderPrepared(world, threadPool);
+		}
+
+		/// <summary>
+		/// Renders as Render does, but from a world that's already been prepared and hasn't changed since, which is
+		/// only read. For renders sharing a world that's prepared once, which could otherwise race to prepare it.
+		/// </summary>
+		Canvas RenderPrepared(const World& world, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			TraceScope trace("Render");
+			Prepare();
+
+			Canvas image(RenderWidth, RenderHeight, Layout);
+			std::vector<Region> tiles = GetRegion().Tiles(TileSize);
+			threadPool.ParallelFor(tiles.size(), [&](size_t tile)
+			{
+				const Region& region = tiles[tile];
+				TraceScope tileTrace("Tile", region.X, region.Y, region.Width, region.Height);
+				Render(world, region, image);
+			});
+
+			return image;
+		}
+
+		// Called with the camera's index and its image, from whichever thread finished the image's last tile.
+		using BatchCallback = std::function<void(size_t camera, const Canvas& image)>;
+
+		/// <summary>
+		/// Renders the world from every camera with a single preparation of the world, sharing the thread pool
+		/// between them. Tiles from the different views are interleaved, so that a view that's costly to render
+		/// doesn't leave threads idle at the end while it finishes.
+		/// </summary>
+		/// <returns>An image for each camera, in the same order.</returns>
+		static std::vector<Canvas> RenderBatch(const World& world, std::span<const Camera> cameras,
+		                                       const BatchCallback& onFinished = {},
+		                                       ThreadPool& threadPool = ThreadPool::Shared())
+		{
+			TraceScope trace("Render batch");
+			world.Prepare();
+
+			struct BatchTile
+			{
+				size_t Camera;
+
+				Region Tile;
+			};
+
+			std::vector<Canvas> images;
+			std::vector<std::vector<Region>> cameraTiles;
+			size_t mostTiles = 0;
+			for (const Camera& camera : cameras)
+			{
+				camera.Prepare();
+				images.emplace_back(camera.RenderWidth, camera.RenderHeight, camera.Layout);
+				cameraTiles.push_back(camera.GetRegion().Tiles(TileSize));
+				mostTiles = std::max(mostTiles, cameraTiles.back().size());
+			}
 
-			// Pixels in world space.
-			float worldX = HalfWidth - (xOffset * PixelSize);
-			float worldY = HalfHeight - (yOffset * PixelSize);
+			// The first tile of every view, then the second of every view, and so on.
+			std::vector<BatchTile> tiles;
+			for (size_t round = 0; round < mostTiles; ++round)
+			{
+				for (size_t camera = 0; camera < cameras.size(); ++camera)
+				{
+					if (round < cameraTiles[camera].size()) { tiles.push_back({camera, cameraTiles[camera][round]}); }
+				}
+			}
 
-			// Compute the ray's origin and direction using the camera's transform, treating the canvas as
-			// at Z=-1.
-			Tuple pixel = Transform.Inverted() * Tuple::Point(worldX, worldY, -1);
-			Tuple origin = Transform.Inverted() * Tuple::Point(0, 0, 0);
-			Tuple direction = (pixel - origin).Normalised();
+			std::vector<std::atomic<size_t>> remaining(cameras.size());
+			for (size_t camera = 0; camera < cameras.size(); ++camera)
+			{
+				remaining[camera] = cameraTiles[camera].size();
+			}
 
-			return {origin, direction};
+			threadPool.ParallelFor(tiles.size(), [&](size_t tile)
+			{
+				const BatchTile& batchTile = tiles[tile];
+				const Region& region = batchTile.Tile;
+				{
+					TraceScope tileTrace("Tile", region.X, region.Y, region.Width, region.Height);
+					cameras[batchTile.Camera].Render(world, region, images[batchTile.Camera]);
+				}
+
+				if (--remaining[batchTile.Camera] == 0 && onFinished)
+				{
+					onFinished(batchTile.Camera, images[batchTile.Camera]);
+				}
+			});
+
+			return images;
 		}
 
-		Canvas Render(const World& world) const
+		/// <summary>
+		/// Renders the world from every camera as RenderBatch does, writing each image to its path as soon as it's
+		/// finished.
+		/// </summary>
+		static void RenderBatch(const World& world, std::span<const Camera> cameras, std::span<const std::string> paths,
+		                        ThreadPool& threadPool = ThreadPool::Shared())
 		{
+			assert(paths.size() == cameras.size());
+			RenderBatch(world, cameras, [&](size_t camera, const Canvas& image) { image.WritePPM(paths[camera]); },
+			            threadPool);
+		}
+
+		/// <summary>
+		/// Starts rendering the whole image in the background, returning a handle to watch, cancel or wait on it.
+		/// The camera is copied, but the world is used as it is, so it must outlive the job and not be changed until
+		/// the job has finished.
+		/// </summary>
+		RenderJob RenderAsync(const World& world, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			world.Prepare();
+			Prepare();
+
+			auto render = [camera = *this, &world](const Region& region, Canvas& image)
+			{
+				camera.Render(world, region, image);
+			};
+
+			return RenderJob::Start(Canvas(RenderWidth, RenderHeight, Layout), GetRegion().Tiles(TileSize), render,
+			                        threadPool);
+		}
+
+		/// <summary>
+		/// Renders the image a band of rows at a time, writing each band to the output in order as soon as it's
+		/// done, so that only one band is ever held rather than the whole image. Each band is split into tiles
+		/// across the thread pool, and the image comes out the same as Render's whatever the band height.
+		/// </summary>
+		void RenderStreaming(const World& world, std::ostream& output, StreamFormat format = StreamFormat::BinaryPPM,
+		                     int bandHeight = TileSize, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			TraceScope trace("Render streaming");
+			assert(bandHeight > 0);
+
+			world.Prepare();
+			Prepare();
+
+			Canvas::WriteHeader(output, format, RenderWidth, RenderHeight);
+
+			Canvas band(RenderWidth, std::min(bandHeight, RenderHeight));
+			for (int y = 0; y < RenderHeight; y += bandHeight)
+			{
+				Region region{0, y, RenderWidth, std::min(bandHeight, RenderHeight - y)};
+				std::vector<Region> tiles = region.Tiles(TileSize);
+				threadPool.ParallelFor(tiles.size(), [&](size_t tile)
+				{
+					const Region& tileRegion = tiles[tile];
+					TraceScope tileTrace("Tile", tileRegion.X, tileRegion.Y, tileRegion.Width, tileRegion.Height);
+					Render(world, tileRegion, band, tileRegion.X, tileRegion.Y - y);
+				});
+
+				TraceScope writeTrace("Write band");
+				band.WriteRows(output, format, region.Height);
+				if (!output) { throw std::runtime_error("Failed to write rendered band"); }
+			}
+		}
+
+		/// <summary>
+		/// Renders the image a band at a time into a file, as RenderStreaming does.
+		/// </summary>
+		void RenderStreaming(const World& world, const std::string& path, StreamFormat format = StreamFormat::BinaryPPM,
+		                     int bandHeight = TileSize, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			std::ofstream output(path, std::ios::binary);
+			if (!output) { throw std::runtime_error("Couldn't open " + path + " to write"); }
+
+			RenderStreaming(world, output, format, bandHeight, threadPool);
+		}
+
+		/// <summary>
+		/// Renders the whole image as Render does, skipping tiles the checkpoint already has and adding each tile to
+		/// it as it's finished. A render that dies part way is resumed by rendering again with a checkpoint opened
+		/// from the same file.
+		/// </summary>
+		Canvas Render(const World& world, Checkpoint& checkpoint, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			TraceScope trace("Render");
+			assert(checkpoint.GetRegion() == GetRegion());
+
+			world.Prepare();
+			Prepare();
+
 			Canvas image(RenderWidth, RenderHeight);
-			for (int x = 0; x < RenderWidth; ++x)
+			checkpoint.Restore(image);
+
+			const std::vector<Region>& tiles = checkpoint.GetTiles();
+			std::vector<size_t> remaining;
+			for (size_t tile = 0; tile < tiles.size(); ++tile)
 			{
-				for (int y = 0; y < RenderHeight; ++y)
+				if (!checkpoint.IsTileDone(tile)) { remaining.push_back(tile); }
+			}
+
+			threadPool.ParallelFor(remaining.size(), [&](size_t i)
+			{
+				const Region& region = tiles[remaining[i]];
+				TraceScope tileTrace("Tile", region.X, region.Y, region.Width, region.Height);
+				Render(world, region, image);
+				checkpoint.SetTile(remaining[i], image);
+			});
+
+			checkpoint.Commit();
+			return image;
+		}
+
+		/// <summary>
+		/// Renders the whole image, also keeping every pixel's primary hit in the G-buffer so that Relight can shade
+		/// the image again later without finding them again.
+		/// </summary>
+		Canvas Render(const World& world, GBuffer& gBuffer, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			world.Prepare();
+			Prepare();
+
+			Canvas image(RenderWidth, RenderHeight);
+			Canvas::LayoutAccess<CanvasLayout::Linear> pixels(image);
+			gBuffer = GBuffer(RenderWidth, RenderHeight);
+			std::vector<Region> tiles = GetRegion().Tiles(TileSize);
+			threadPool.ParallelFor(tiles.size(), [&](size_t tile)
+			{
+				ForEachPixel(tiles[tile], [&](int x, int y, const Ray& ray)
+				{
+					std::optional<Shape::Computation> hit = world.ComputationAt(ray);
+					if (hit) { pixels.SetPixel(x, y, world.ShadeIntersection(*hit, Settings)); }
+					gBuffer.SetHit(x, y, hit);
+				});
+			});
+
+			return image;
+		}
+
+		/// <summary>
+		/// Shades the primary hits kept from an earlier render with the world's current materials and light. Much
+		/// faster than rendering again, but only valid if nothing has moved since.
+		/// </summary>
+		Canvas Relight(const World& world, const GBuffer& gBuffer, ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			assert(gBuffer.GetWidth() == RenderWidth && gBuffer.GetHeight() == RenderHeight);
+			world.Prepare();
+
+			Canvas image(RenderWidth, RenderHeight);
+			Canvas::LayoutAccess<CanvasLayout::Linear> pixels(image);
+			std::vector<Region> tiles = GetRegion().Tiles(TileSize);
+			threadPool.ParallelFor(tiles.size(), [&](size_t tile)
+			{
+				for (int y = tiles[tile].Y; y < tiles[tile].Bottom(); ++y)
 				{
-					Ray ray = RayForPixel(x, y);
-					Tuple colour = world.ColourAt(ray);
-					image.SetPixel(x, y, colour);
+					for (int x = tiles[tile].X; x < tiles[tile].Right(); ++x)
+					{
+						const std::optional<Shape::Computation>& hit = gBuffer.GetHit(x, y);
+						if (hit) { pixels.SetPixel(x, y, world.ShadeIntersection(*hit, Settings)); }
+					}
 				}
+			});
+
+			return image;
+		}
+
+		/// <summary>
+		/// Renders the whole image as a normal render would, but shows what each pixel cost rather than its colour,
+		/// on a ramp from blue for the cheapest through green and yellow to red for the most expensive. Pixels are
+		/// rendered by the same code as Render, so the costs are those of a normal render.
+		/// </summary>
+		Canvas RenderHeatmap(const World& world, HeatmapMetric metric,
+		                     ThreadPool& threadPool = ThreadPool::Shared()) const
+		{
+			TraceScope trace("Render heatmap");
+
+			world.Prepare();
+			Prepare();
+
+			RenderStatistics::CollectionScope collecting;
+			std::vector<float> costs(static_cast<size_t>(RenderWidth) * RenderHeight);
+			std::vector<Region> tiles = GetRegion().Tiles(TileSize);
+			threadPool.ParallelFor(tiles.size(), [&](size_t tile)
+			{
+				RenderStatistics& statistics = RenderStatistics::ThisThread();
+				ForEachPixel(tiles[tile], [&](int x, int y, const Ray& ray)
+				{
+					statistics.Reset();
+					auto start = std::chrono::steady_clock::now();
+					world.ColourAt(ray, Settings);
+					auto end = std::chrono::steady_clock::now();
+
+					float cost = metric == HeatmapMetric::Nanoseconds
+						? std::chrono::duration<float, std::nano>(end - start).count() : statistics.Get(metric);
+					costs[static_cast<size_t>(y) * RenderWidth + x] = cost;
+				});
+			});
+
+			// Normalised to the most expensive pixel, so a flat image shows every pixel costing the same.
+			float highest = costs.empty() ? 0 : *std::ranges::max_element(costs);
+			Canvas image(RenderWidth, RenderHeight);
+			for (int y = 0; y < RenderHeight; ++y)
+			{
+				for (int x = 0; x < RenderWidth; ++x)
+				{
+					float cost = costs[static_cast<size_t>(y) * RenderWidth + x];
+					image.SetPixel(x, y, HeatmapColour(highest > 0 ? cost / highest : 0));
+				}
+			}
+
+			return image;
+		}
+
+		/// <param name="heat">From 0 for blue up to 1 for red.</param>
+		static Tuple HeatmapColour(float heat)
+		{
+			constexpr Tuple ramp[] = {Tuple::Colour(0, 0, 1), Tuple::Colour(0, 1, 1), Tuple::Colour(0, 1, 0),
+			                          Tuple::Colour(1, 1, 0), Tuple::Colour(1, 0, 0)};
+			constexpr int segments = std::size(ramp) - 1;
+
+			float position = std::clamp(heat, 0.0f, 1.0f) * segments;
+			int segment = std::min(static_cast<int>(position), segments - 1);
+			float fraction = position - segment;
+
+			return ramp[segment] * (1 - fraction) + ramp[segment + 1] * fraction;
+		}
+
+		/// <summary>
+		/// Renders only the pixels inside the region into a canvas of the region's size.
+		/// </summary>
+		Canvas Render(const World& world, const Region& region) const
+		{
+			Canvas image(region.Width, region.Height);
+			Render(world, region, image, 0, 0);
+
+			return image;
+		}
+
+		/// <summary>
+		/// Works out what rays are traced from the camera's current settings and keeps it, as rendering does before
+		/// starting any threads. Needed first by anything else rendering from the camera in parallel, such as forked
+		/// processes, which would otherwise each work it out again for every tile. Nothing is written if the camera
+		/// hasn't changed since, so preparing a camera that's already rendering is safe.
+		/// </summary>
+		void Prepare() const
+		{
+			if (!IsCurrent(Basis_)) { Basis_ = MakeBasis(); }
+		}
+
+		/// <summary>
+		/// Renders only the pixels inside the region into the same pixels of the target.
+		/// </summary>
+		void Render(const World& world, const Region& region, Canvas& target) const
+		{
+			Render(world, region, target, region.X, region.Y);
+		}
+
+		/// <summary>
+		/// Renders only the pixels inside the region into an image held as red, green and blue floats for every pixel,
+		/// row after row, the size of the camera's image. For framebuffers that can't be a Canvas, such as one shared
+		/// between processes.
+		/// </summary>
+		void Render(const World& world, const Region& region, float* pixels) const
+		{
+			assert(GetRegion().Contains(region));
+
+			ForEachPixel(region, [&](int x, int y, const Ray& ray)
+			{
+				Tuple colour = world.ColourAt(ray, Settings);
+				float* pixel = pixels + (static_cast<size_t>(y) * RenderWidth + x) * 3;
+				pixel[0] = colour.X;
+				pixel[1] = colour.Y;
+				pixel[2] = colour.Z;
+			});
+		}
+
+		/// <summary>
+		/// Renders only the pixels inside the region, writing them into the target with the region's top left corner
+		/// at targetX, targetY. Nothing is done for pixels outside the region, and the rest of the target is left
+		/// untouched, so a canvas can be filled a piece at a time.
+		/// </summary>
+		void Render(const World& world, const Region& region, Canvas& target, int targetX, int targetY) const
+		{
+			assert(GetRegion().Contains(region));
+			assert(target.GetRegion().Contains({targetX, targetY, region.Width, region.Height}));
+
+			// The layout is chosen once for the tile rather than for every pixel.
+			target.WithLayoutAccess([&](auto pixels)
+			{
+				ForEachPixel(region, [&](int x, int y, const Ray& ray)
+				{
+					Tuple colour = world.ColourAt(ray, Settings);
+					pixels.SetPixel(targetX + x - region.X, targetY + y - region.Y, colour);
+				});
+			});
+		}
+
+		/// <summary>
+		/// Renders the same image as Render, but a tile at a time through the Wavefront stages rather than a pixel
+		/// at a time. A tile size of 0 or less queues the whole frame as a single tile.
+		/// </summary>
+		Canvas RenderWavefront(const World& world, int tileSize = 0) const
+		{
+			TraceScope trace("Render wavefront");
+			if (tileSize <= 0) { tileSize = std::max(RenderWidth, RenderHeight); }
+
+			Canvas image(RenderWidth, RenderHeight);
+			Wavefront wavefront(world, Settings);
+
+			std::vector<Wavefront::PathRay> queue;
+			for (const Region& tile : GetRegion().Tiles(tileSize))
+			{
+				TraceScope tileTrace("Tile", tile.X, tile.Y, tile.Width, tile.Height);
+				queue.clear();
+				ForEachPixel(tile, [&](int x, int y, const Ray& ray) { queue.push_back({ray, x, y}); });
+
+				wavefront.Trace(std::move(queue), image);
 			}
 
 			return image;
 		}
+
+	private:
+		/// <summary>
+		/// Everything about the canvas in world space which every pixel's ray is worked out from. Derived from the
+		/// transform and the canvas size, along with the values it was derived from, so that it's only recalculated
+		/// after they change.
+		/// </summary>
+		struct Basis
+		{
+			Matrix<4> Transform;
+
+			float HalfWidth;
+
+			float HalfHeight;
+
+			float PixelSize;
+
+			// Where every ray starts.
+			Tuple Origin;
+
+			// Centre of the top left pixel.
+			Tuple FirstPixel;
+
+			// Offset from a pixel's centre to the next pixel's centre along a row.
+			Tuple StepX;
+
+			// Offset from a pixel's centre to the next pixel's centre down a column.
+			Tuple StepY;
+
+			bool IsValid = false;
+		};
+
+		// Only ever written by Prepare.
+		mutable Basis Basis_;
+
+		bool IsCurrent(const Basis& basis) const
+		{
+			return basis.IsValid && basis.Transform.Values == Transform.Values && basis.HalfWidth == HalfWidth &&
+				basis.HalfHeight == HalfHeight && basis.PixelSize == PixelSize;
+		}
+
+		Basis MakeBasis() const
+		{
+			// Treating the canvas as at Z=-1, and the camera looking down -Z. The canvas' +X is the world's -X.
+			Affine inverse = Affine::From(Transform).Inverted();
+			Basis basis;
+			basis.Transform = Transform;
+			basis.HalfWidth = HalfWidth;
+			basis.HalfHeight = HalfHeight;
+			basis.PixelSize = PixelSize;
+			basis.Origin = inverse.TransformPoint(Tuple::Point(0, 0, 0));
+			basis.FirstPixel = inverse.TransformPoint(Tuple::Point(HalfWidth - 0.5f * PixelSize,
+				HalfHeight - 0.5f * PixelSize, -1));
+			basis.StepX = inverse.TransformVector(Tuple::Vector(-PixelSize, 0, 0));
+			basis.StepY = inverse.TransformVector(Tuple::Vector(0, -PixelSize, 0));
+			basis.IsValid = true;
+
+			return basis;
+		}
+
+		/// <returns>
+		/// The basis kept by Prepare, or if the camera has changed since, one worked out again without keeping it.
+		/// Only reads the camera, so any number of threads can call it while rendering.
+		/// </returns>
+		Basis GetBasis() const { return IsCurrent(Basis_) ? Basis_ : MakeBasis(); }
+
+		void RaysForRow(const Basis& basis, int y, int firstX, std::span<Ray> rays) const
+		{
+			// Direction to the first pixel, before normalisation.
+			Tuple rowStart = basis.FirstPixel + basis.StepY * static_cast<float>(y) +
+				basis.StepX * static_cast<float>(firstX) - basis.Origin;
+
+			constexpr size_t BatchSize = 64;
+			float directionX[BatchSize], directionY[BatchSize], directionZ[BatchSize];
+
+			for (size_t first = 0; first < rays.size(); first += BatchSize)
+			{
+				size_t count = std::min(BatchSize, rays.size() - first);
+
+				// Multiplying rather than accumulating the step, so that error doesn't build up along the row.
+				for (size_t i = 0; i < count; ++i)
+				{
+					float step = static_cast<float>(first + i);
+					directionX[i] = rowStart.X + basis.StepX.X * step;
+					directionY[i] = rowStart.Y + basis.StepX.Y * step;
+					directionZ[i] = rowStart.Z + basis.StepX.Z * step;
+				}
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					float scale = 1.0f / std::sqrt(directionX[i] * directionX[i] + directionY[i] * directionY[i] +
+						directionZ[i] * directionZ[i]);
+					directionX[i] *= scale;
+					directionY[i] *= scale;
+					directionZ[i] *= scale;
+				}
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					rays[first + i] = {basis.Origin, Tuple::Vector(directionX[i], directionY[i], directionZ[i])};
+				}
+			}
+		}
+
+		/// <summary>
+		/// Calls the function with each pixel in the region and its ray, generating the rays a row at a time. The
+		/// memory the rays traced for the region used is reported once at the end, rather than for every ray.
+		/// </summary>
+		template <typename Function>
+		void ForEachPixel(const Region& region, Function&& function) const
+		{
+			Basis basis = GetBasis();
+			std::vector<Ray> rays(region.Width);
+			TrackedBytes memory(MemoryCategory::RayBuffers, rays.capacity() * sizeof(Ray));
+			for (int y = region.Y; y < region.Bottom(); ++y)
+			{
+				RaysForRow(basis, y, region.X, rays);
+				for (int x = region.X; x < region.Right(); ++x) { function(x, y, rays[x - region.X]); }
+			}
+
+			MemoryTracker::FlushThisThread();
+		}
 	};
 }
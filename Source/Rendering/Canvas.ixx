@@ -2,52 +2,552 @@ module;
 #include "vector"
 #include "format"
 #include <algorithm>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <fstream>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 export module RayTracer:Canvas;
+import :Memory;
+import :Morton;
+import :Trace;
 import :Tuple;
 
 namespace RayTracer
 {
+	/// <summary>
+	/// A rectangle of pixels, used to address part of an image.
+	/// </summary>
+	export struct Region
+	{
+		int X = 0;
+
+		int Y = 0;
+
+		int Width = 0;
+
+		int Height = 0;
+
+		int Right() const { return X + Width; }
+
+		int Bottom() const { return Y + Height; }
+
+		bool Contains(const Region& other) const
+		{
+			return other.X >= X && other.Y >= Y && other.Right() <= Right() && other.Bottom() <= Bottom();
+		}
+
+		/// <summary>
+		/// Splits the region into tiles of at most tileSize by tileSize pixels, row by row. Tiles on the right and
+		/// bottom edges are cut short rather than overhanging the region. Throws for tiles less than a pixel across,
+		/// which would otherwise never get past the first tile.
+		/// </summary>
+		std::vector<Region> Tiles(int tileSize) const
+		{
+			if (tileSize <= 0) { throw std::runtime_error(std::format("Tile size {} is not positive.", tileSize)); }
+
+			std::vector<Region> tiles;
+			for (int y = Y; y < Bottom(); y += tileSize)
+			{
+				for (int x = X; x < Right(); x += tileSize)
+				{
+					tiles.push_back({x, y, std::min(tileSize, Right() - x), std::min(tileSize, Bottom() - y)});
+				}
+			}
+
+			return tiles;
+		}
+
+		bool operator==(const Region& rhs) const = default;
+	};
+
+	/// <summary>
+	/// How images are written a band of rows at a time, for images too big to hold whole.
+	/// </summary>
+	export enum class StreamFormat
+	{
+		// Binary PPM, 8 bits per channel.
+		BinaryPPM,
+
+		// Red, green and blue floats per pixel in the machine's byte order, row by row with no header. Keeps colours
+		// above 1 for post-processing later.
+		RawFloat
+	};
+
+	/// <summary>
+	/// How a canvas orders its pixels in memory. Whatever the layout, pixels are read and written by coordinate and
+	/// images are written out row by row.
+	/// </summary>
+	export enum class CanvasLayout
+	{
+		// Row after row. The simplest to hand to anything else, but neighbours above and below are a whole row apart.
+		Linear,
+
+		// Square blocks of pixels one after another, row by row, with each block's pixels row by row. A tile being
+		// rendered, or a small neighbourhood a filter reads, covers a few blocks rather than many rows.
+		Tiled,
+
+		// As Tiled, but with each block's pixels along a Z order curve, so that any 2 by 2, 4 by 4 or 8 by 8 square
+		// aligned within a block is contiguous.
+		Morton
+	};
+
 	export class Canvas
 	{
+	public:
+		// Width and height of the blocks of the tiled layouts, a power of two. 8 by 8 pixels fill a kilobyte.
+		static constexpr int BlockSize = 8;
+
 		// FIELDS
 	private:
+		static constexpr int BlockShift = 3;
+		static constexpr int BlockMask = BlockSize - 1;
+		static constexpr int BlockArea = BlockSize * BlockSize;
+		static_assert(1 << BlockShift == BlockSize);
+
 		int Width, Height;
+		CanvasLayout Layout;
+		// Blocks in each row of blocks, for the tiled layouts. Blocks on the right and bottom edges are padded out
+		// to a whole block, so the pixels take a little more room than the image.
+		int BlocksAcross;
 		std::vector<Tuple> Pixels;
+		TrackedBytes Memory{MemoryCategory::Framebuffers};
 
 	public:
+		/// <summary>
+		/// Visits the pixels of a region of a canvas row by row, left to right, giving each one by reference.
+		/// </summary>
+		template <typename CanvasType>
+		class PixelIterator
+		{
+			CanvasType* Canvas_ = nullptr;
+			Region Region_;
+			int X_ = 0, Y_ = 0;
+
+		public:
+			using value_type = Tuple;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::conditional_t<std::is_const_v<CanvasType>, const Tuple&, Tuple&>;
+			using iterator_category = std::forward_iterator_tag;
+
+			PixelIterator() = default;
+
+			PixelIterator(CanvasType& canvas, const Region& region, int x, int y) : Canvas_(&canvas),
+				Region_(region), X_(x), Y_(y) {}
+
+			reference operator*() const { return Canvas_->Pixels[Canvas_->IndexOf(X_, Y_)]; }
+
+			PixelIterator& operator++()
+			{
+				if (++X_ == Region_.Right())
+				{
+					X_ = Region_.X;
+					++Y_;
+				}
+				return *this;
+			}
+
+			PixelIterator operator++(int)
+			{
+				PixelIterator previous = *this;
+				++*this;
+				return previous;
+			}
+
+			int GetX() const { return X_; }
+			int GetY() const { return Y_; }
+
+			bool operator==(const PixelIterator& rhs) const { return X_ == rhs.X_ && Y_ == rhs.Y_; }
+		};
+
+		/// <summary>
+		/// The pixels of a region, to loop over with a range-based for.
+		/// </summary>
+		template <typename CanvasType>
+		class PixelRange
+		{
+			PixelIterator<CanvasType> First_, Last_;
+
+		public:
+			PixelRange(CanvasType& canvas, const Region& region) :
+				First_(canvas, region, region.X, region.Width > 0 ? region.Y : region.Bottom()),
+				Last_(canvas, region, region.X, region.Bottom()) {}
+
+			PixelIterator<CanvasType> begin() const { return First_; }
+			PixelIterator<CanvasType> end() const { return Last_; }
+		};
+
+		/// <summary>
+		/// Reads and writes the pixels of a canvas with the layout fixed when compiled, so that a loop over many pixels
+		/// finds each one without checking the layout. Got through WithLayoutAccess, which checks it once for the
+		/// whole loop, or made directly for a canvas known to have the layout.
+		/// </summary>
+		template <CanvasLayout LayoutType>
+		class LayoutAccess
+		{
+			Tuple* Pixels_;
+			int Width_, BlocksAcross_;
+
+		public:
+			explicit LayoutAccess(Canvas& canvas) : Pixels_(canvas.Pixels.data()), Width_(canvas.Width),
+				BlocksAcross_(canvas.BlocksAcross)
+			{
+				assert(canvas.Layout == LayoutType);
+			}
+
+			Tuple GetPixel(int x, int y) const { return Pixels_[IndexIn<LayoutType>(x, y, Width_, BlocksAcross_)]; }
+
+			void SetPixel(int x, int y, const Tuple& colour) const
+			{
+				Pixels_[IndexIn<LayoutType>(x, y, Width_, BlocksAcross_)] = colour;
+			}
+		};
+
 		// CONSTRUCTORS
-		Canvas(int width, int height) : Width{ width }, Height{ height }, Pixels(width * height) {  }
+		Canvas(int width, int height, CanvasLayout layout = CanvasLayout::Linear) : Width{ width }, Height{ height },
+			Layout{ layout }, BlocksAcross{ (width + BlockMask) >> BlockShift }
+		{
+			if (Layout == CanvasLayout::Linear) { Pixels.resize(static_cast<size_t>(width) * height); }
+			else
+			{
+				int blocksDown = (height + BlockMask) >> BlockShift;
+				Pixels.resize(static_cast<size_t>(BlocksAcross) * blocksDown * BlockArea);
+			}
+
+			Memory.Set(Pixels.capacity() * sizeof(Tuple));
+		}
 
 		// METHODS
 		// GETTERS
 		int GetWidth() const { return Width; }
 		int GetHeight() const { return Height; }
-		const std::vector<Tuple>& GetPixels() const { return Pixels; }
+		CanvasLayout GetLayout() const { return Layout; }
+		Region GetRegion() const { return {0, 0, Width, Height}; }
+
+		/// <summary>
+		/// The pixels as they're stored, only for linear canvases where that's row by row. ToLinear gives the same
+		/// for a canvas of any layout.
+		/// </summary>
+		const std::vector<Tuple>& GetPixels() const
+		{
+			assert(Layout == CanvasLayout::Linear);
+			return Pixels;
+		}
 
 		Tuple GetPixel(int x, int y) const
 		{
-			return Pixels[Width * y + x];
+			return Pixels[IndexOf(x, y)];
 		}
 
 		void SetPixel(int x, int y, const Tuple& colour)
 		{
-			Pixels[Width * y + x] = colour;
+			Pixels[IndexOf(x, y)] = colour;
+		}
+
+		/// <summary>
+		/// Calls the function with the LayoutAccess for the canvas's layout, for loops that read or write many pixels.
+		/// </summary>
+		template <typename Function>
+		void WithLayoutAccess(Function&& function)
+		{
+			switch (Layout)
+			{
+			case CanvasLayout::Linear: function(LayoutAccess<CanvasLayout::Linear>(*this)); break;
+			case CanvasLayout::Tiled: function(LayoutAccess<CanvasLayout::Tiled>(*this)); break;
+			case CanvasLayout::Morton: function(LayoutAccess<CanvasLayout::Morton>(*this)); break;
+			}
+		}
+
+		PixelRange<Canvas> Row(int y) { return {*this, {0, y, Width, 1}}; }
+		PixelRange<const Canvas> Row(int y) const { return {*this, {0, y, Width, 1}}; }
+
+		PixelRange<Canvas> Tile(const Region& region)
+		{
+			assert(GetRegion().Contains(region));
+			return {*this, region};
+		}
+
+		PixelRange<const Canvas> Tile(const Region& region) const
+		{
+			assert(GetRegion().Contains(region));
+			return {*this, region};
 		}
 
-		void WritePPM() const
+		/// <summary>
+		/// Splits the image into tiles that each cover whole blocks of the layout, in the order they're stored. Work
+		/// done a tile at a time in this order, such as a filter, walks through memory rather than across it.
+		/// </summary>
+		/// <param name="blocks">Blocks along each side of a tile.</param>
+		std::vector<Region> GetBlocks(int blocks = 1) const { return GetRegion().Tiles(blocks * BlockSize); }
+
+		/// <summary>
+		/// Copies a row of pixels into row, which must be at least as wide as the image, left to right.
+		/// </summary>
+		void CopyRow(int y, std::span<Tuple> row) const
 		{
-			std::ofstream image("render.ppm");
+			assert(row.size() >= static_cast<size_t>(Width));
+			switch (Layout)
+			{
+			case CanvasLayout::Linear:
+				std::copy_n(Pixels.begin() + static_cast<size_t>(Width) * y, Width, row.begin());
+				break;
+
+			case CanvasLayout::Tiled:
+				// Each block holds a run of the row that's contiguous.
+				for (int x = 0; x < Width; x += BlockSize)
+				{
+					std::copy_n(Pixels.begin() + IndexOf(x, y), std::min(BlockSize, Width - x), row.begin() + x);
+				}
+				break;
+
+			case CanvasLayout::Morton:
+				for (int x = 0; x < Width; ++x) { row[x] = Pixels[IndexOf(x, y)]; }
+				break;
+			}
+		}
+
+		/// <returns>Every pixel row by row, whatever the layout.</returns>
+		std::vector<Tuple> ToLinear() const
+		{
+			if (Layout == CanvasLayout::Linear) { return Pixels; }
+
+			std::vector<Tuple> pixels(static_cast<size_t>(Width) * Height);
+			for (int y = 0; y < Height; ++y)
+			{
+				CopyRow(y, std::span(pixels).subspan(static_cast<size_t>(Width) * y, Width));
+			}
+
+			return pixels;
+		}
+
+		/// <returns>A copy of the image with its pixels in another layout.</returns>
+		Canvas WithLayout(CanvasLayout layout) const
+		{
+			Canvas canvas(Width, Height, layout);
+			std::vector<Tuple> row(Width);
+			for (int y = 0; y < Height; ++y)
+			{
+				CopyRow(y, row);
+				std::ranges::copy(row, canvas.Row(y).begin());
+			}
+
+			return canvas;
+		}
+
+		/// <summary>
+		/// Writes the image as a plain PPM to render.ppm in the working directory.
+		/// </summary>
+		void WritePPM() const { WritePPM("render.ppm"); }
+
+		void WritePPM(const std::string& path) const
+		{
+			std::ofstream image(path);
+			if (!image) { throw std::runtime_error("Couldn't open " + path + " to write"); }
+
+			WritePPM(image);
+		}
+
+		void WritePPM(std::ostream& image) const
+		{
+			TraceScope trace("Write image");
 			image << std::format("P3\n{} {}\n255\n", Width, Height);
 
-			for (const Tuple& pixel : Pixels)
+			std::vector<Tuple> row(Width);
+			for (int y = 0; y < Height; ++y)
+			{
+				CopyRow(y, row);
+				for (const Tuple& pixel : row)
+				{
+					image << std::format("{} {} {} ", ToByte(pixel.X), ToByte(pixel.Y), ToByte(pixel.Z));
+				}
+			}
+		}
+
+		/// <summary>
+		/// Writes what comes before the pixels of an image of the given size in the format, if anything.
+		/// </summary>
+		static void WriteHeader(std::ostream& image, StreamFormat format, int width, int height)
+		{
+			if (format == StreamFormat::BinaryPPM) { image << std::format("P6\n{} {}\n255\n", width, height); }
+		}
+
+		/// <summary>
+		/// Writes the first rows of pixels in the format, to follow the header and any rows written before.
+		/// </summary>
+		void WriteRows(std::ostream& image, StreamFormat format, int rowCount) const
+		{
+			size_t pixelCount = static_cast<size_t>(Width) * rowCount;
+			std::vector<Tuple> row(Width);
+			if (format == StreamFormat::RawFloat)
+			{
+				std::vector<float> values;
+				values.reserve(pixelCount * 3);
+				for (int y = 0; y < rowCount; ++y)
+				{
+					CopyRow(y, row);
+					for (const Tuple& pixel : row) { values.insert(values.end(), {pixel.X, pixel.Y, pixel.Z}); }
+				}
+				image.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+				return;
+			}
+
+			std::vector<uint8_t> bytes;
+			bytes.reserve(pixelCount * 3);
+			for (int y = 0; y < rowCount; ++y)
+			{
+				CopyRow(y, row);
+				for (const Tuple& pixel : row)
+				{
+					bytes.insert(bytes.end(), {static_cast<uint8_t>(ToByte(pixel.X)),
+					                           static_cast<uint8_t>(ToByte(pixel.Y)),
+					                           static_cast<uint8_t>(ToByte(pixel.Z))});
+				}
+			}
+			image.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		}
+
+		/// <summary>
+		/// Reads a plain or binary PPM, as written by WritePPM or WriteRows, with any maximum value.
+		/// </summary>
+		static Canvas ReadPPM(std::istream& image)
+		{
+			std::string magic;
+			int width = 0, height = 0, maximum = 0;
+			image >> magic >> width >> height >> maximum;
+			bool isBinary = magic == "P6";
+			if (!image || (magic != "P3" && !isBinary) || width <= 0 || height <= 0 || maximum <= 0 ||
+				(isBinary && maximum > 255))
+			{
+				throw std::runtime_error("Not a PPM image");
+			}
+
+			// Binary pixels start straight after the single whitespace character ending the header.
+			if (isBinary) { image.get(); }
+
+			Canvas canvas(width, height);
+			for (Tuple& pixel : canvas.Pixels)
+			{
+				int red, green, blue;
+				if (isBinary)
+				{
+					uint8_t channels[3];
+					if (!image.read(reinterpret_cast<char*>(channels), 3))
+					{
+						throw std::runtime_error("PPM image ended early");
+					}
+					red = channels[0], green = channels[1], blue = channels[2];
+				}
+				else if (!(image >> red >> green >> blue)) { throw std::runtime_error("PPM image ended early"); }
+
+				pixel = Tuple::Colour(static_cast<float>(red) / maximum, static_cast<float>(green) / maximum,
+				                      static_cast<float>(blue) / maximum);
+			}
+
+			return canvas;
+		}
+
+		static Canvas ReadPPM(const std::string& path)
+		{
+			std::ifstream image(path, std::ios::binary);
+			if (!image) { throw std::runtime_error("Couldn't open " + path + " to read"); }
+
+			return ReadPPM(image);
+		}
+
+		/// <summary>
+		/// Reads an image written with StreamFormat::RawFloat, which doesn't record its own size.
+		/// </summary>
+		static Canvas ReadRawFloat(std::istream& image, int width, int height)
+		{
+			Canvas canvas(width, height);
+			for (Tuple& pixel : canvas.Pixels)
+			{
+				float channels[3];
+				if (!image.read(reinterpret_cast<char*>(channels), sizeof(channels)))
+				{
+					throw std::runtime_error("Raw image ended early");
+				}
+				pixel = Tuple::Colour(channels[0], channels[1], channels[2]);
+			}
+
+			return canvas;
+		}
+
+		static Canvas ReadRawFloat(const std::string& path, int width, int height)
+		{
+			std::ifstream image(path, std::ios::binary);
+			if (!image) { throw std::runtime_error("Couldn't open " + path + " to read"); }
+
+			return ReadRawFloat(image, width, height);
+		}
+
+		/// <summary>
+		/// Peak signal to noise ratio between two images of the same size, in decibels, comparing them as they'd be
+		/// written out so that differences too small to change a byte don't count.
+		/// </summary>
+		/// <returns>Infinity if the images would be written identically.</returns>
+		static float PSNR(const Canvas& lhs, const Canvas& rhs)
+		{
+			if (lhs.Width != rhs.Width || lhs.Height != rhs.Height) { return 0; }
+
+			double squaredError = 0;
+			std::vector<Tuple> lhsRow(lhs.Width), rhsRow(rhs.Width);
+			for (int y = 0; y < lhs.Height; ++y)
+			{
+				lhs.CopyRow(y, lhsRow);
+				rhs.CopyRow(y, rhsRow);
+				for (int x = 0; x < lhs.Width; ++x)
+				{
+					for (auto channel : {&Tuple::X, &Tuple::Y, &Tuple::Z})
+					{
+						double difference = ToByte(lhsRow[x].*channel) - ToByte(rhsRow[x].*channel);
+						squaredError += difference * difference;
+					}
+				}
+			}
+
+			if (squaredError == 0) { return std::numeric_limits<float>::infinity(); }
+
+			double meanSquaredError = squaredError / (3.0 * lhs.Width * lhs.Height);
+			return static_cast<float>(10 * std::log10(255.0 * 255.0 / meanSquaredError));
+		}
+
+	private:
+		template <CanvasLayout LayoutType>
+		static size_t IndexIn(int x, int y, int width, int blocksAcross)
+		{
+			if constexpr (LayoutType == CanvasLayout::Linear) { return static_cast<size_t>(width) * y + x; }
+			else
+			{
+				size_t block = static_cast<size_t>(y >> BlockShift) * blocksAcross + (x >> BlockShift);
+				int blockX = x & BlockMask, blockY = y & BlockMask;
+				size_t offset;
+				if constexpr (LayoutType == CanvasLayout::Tiled) { offset = blockY * BlockSize + blockX; }
+				else { offset = MortonCode(blockX, blockY); }
+
+				return block * BlockArea + offset;
+			}
+		}
+
+		size_t IndexOf(int x, int y) const
+		{
+			switch (Layout)
 			{
-				int red = std::clamp<float>(round(pixel.X * 255), 0, 255);
-				int green = std::clamp<float>(round(pixel.Y * 255), 0, 255);
-				int blue = std::clamp<float>(round(pixel.Z * 255), 0, 255);
-				image << std::format("{} {} {} ", red, green, blue);
+			case CanvasLayout::Tiled: return IndexIn<CanvasLayout::Tiled>(x, y, Width, BlocksAcross);
+			case CanvasLayout::Morton: return IndexIn<CanvasLayout::Morton>(x, y, Width, BlocksAcross);
+			default: return IndexIn<CanvasLayout::Linear>(x, y, Width, BlocksAcross);
 			}
 		}
+
+		static int ToByte(float channel) { return std::clamp<float>(std::round(channel * 255), 0, 255); }
 	};
 }
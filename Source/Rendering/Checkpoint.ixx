@@ -0,0 +1,265 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module RayTracer:Checkpoint;
+
+import :Canvas;
+import :MappedFile;
+import :Trace;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Finished tiles of a render kept in a memory mapped file, so that a render which dies part way can be resumed
+	/// without rendering them again. The file holds a header, a flag for each tile and the float colour of every
+	/// pixel.\n
+	/// Tiles are written into the file as they're finished but only marked done when committed, which waits for
+	/// their pixels to reach the disk before setting their flags and waiting for those too. A crash at any point
+	/// leaves only tiles whose pixels are safely written marked done. Committing is done at most once an interval,
+	/// so its cost is spread over many tiles.
+	/// </summary>
+	export class Checkpoint
+	{
+		struct Header
+		{
+			char Magic[8];
+
+			uint32_t Version;
+
+			int32_t Width;
+
+			int32_t Height;
+
+			int32_t TileSize;
+
+			uint64_t SceneKey;
+
+			uint64_t TileCount;
+		};
+
+		static constexpr char Magic[8] = "RTCHECK";
+
+		static constexpr uint32_t Version = 1;
+
+		MappedFile File_;
+
+		std::vector<Region> Tiles_;
+
+		int Width_;
+
+		int Height_;
+
+		size_t FlagsOffset_;
+
+		size_t PixelsOffset_;
+
+		std::mutex Mutex_;
+
+		// Finished since the last commit.
+		std::vector<size_t> Pending_;
+
+		std::chrono::steady_clock::time_point LastCommit_ = std::chrono::steady_clock::now();
+
+		std::atomic<size_t> DoneCount_ = 0;
+
+	public:
+		// The longest that finished tiles go without being committed.
+		std::chrono::milliseconds Interval{10000};
+
+		/// <summary>
+		/// Opens the checkpoint file at the path, resuming from it if it's for the same size image, tile size and
+		/// scene, otherwise starting it again from nothing.
+		/// </summary>
+		/// <param name="sceneKey">
+		/// Identifies what's being rendered, such as a hash of the scene file, so that a checkpoint isn't resumed
+		/// for anything else.
+		/// </param>
+		Checkpoint(const std::string& path, int width, int height, int tileSize, uint64_t sceneKey = 0) :
+			Tiles_(Region{0, 0, width, height}.Tiles(tileSize)), Width_(width), Height_(height)
+		{
+			FlagsOffset_ = sizeof(Header);
+			PixelsOffset_ = (FlagsOffset_ + Tiles_.size() + alignof(float) - 1) / alignof(float) * alignof(float);
+			size_t size = PixelsOffset_ + static_cast<size_t>(width) * height * 3 * sizeof(float);
+			File_ = MappedFile::Open(path, size);
+
+			Header expected;
+			std::memset(&expected, 0, sizeof(Header));
+			std::memcpy(expected.Magic, Magic, sizeof(Magic));
+			expected.Version = Version;
+			expected.Width = width;
+			expected.Height = height;
+			expected.TileSize = tileSize;
+			expected.SceneKey = sceneKey;
+			expected.TileCount = Tiles_.size();
+
+			Header& header = *reinterpret_cast<Header*>(File_.GetData());
+			if (File_.Existed() && std::memcmp(&header, &expected, sizeof(Header)) == 0)
+			{
+				DoneCount_ = std::count(GetFlags(), GetFlags() + Tiles_.size(), uint8_t{1});
+				return;
+			}
+
+			// Nothing is marked done until the new header is on disk, so a crash now leaves a checkpoint that's
+			// either the old one or an empty new one.
+			std::memset(&header, 0, sizeof(Header));
+			std::memset(GetFlags(), 0, Tiles_.size());
+			File_.Sync(0, PixelsOffset_);
+			header = expected;
+			File_.Sync(0, sizeof(Header));
+		}
+
+		Checkpoint(const Checkpoint&) = delete;
+
+		Checkpoint& operator=(const Checkpoint&) = delete;
+
+		/// <summary>
+		/// Commits any tiles still pending.
+		/// </summary>
+		~Checkpoint()
+		{
+			try { Commit(); }
+			catch (const std::runtime_error&)
+			{
+				// They'll be rendered again on resuming instead.
+			}
+		}
+
+		/// <summary>
+		/// A key for the scene from its text, such as the scene file, for the constructor. FNV-1a rather than
+		/// std::hash, as the key has to be the same for every build and platform that might resume the checkpoint.
+		/// </summary>
+		static uint64_t SceneKey(std::string_view text)
+		{
+			uint64_t hash = 0xcbf29ce484222325;
+			for (char c : text)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 0x100000001b3;
+			}
+
+			return hash;
+		}
+
+		Region GetRegion() const { return {0, 0, Width_, Height_}; }
+
+		/// <returns>The tiles of the image in the order they're numbered.</returns>
+		const std::vector<Region>& GetTiles() const { return Tiles_; }
+
+		bool IsTileDone(size_t tile) const { return GetFlags()[tile] != 0; }
+
+		/// <returns>How many tiles are committed.</returns>
+		size_t GetDoneCount() const { return DoneCount_; }
+
+		bool IsComplete() const { return DoneCount_ == Tiles_.size(); }
+
+		/// <summary>
+		/// Writes a finished tile's pixels into the file, committing every tile finished so far if it's been at
+		/// least the interval since the last commit. Safe to call from multiple threads with different tiles.
+		/// </summary>
+		/// <param name="image">Holds the tile's pixels at the tile's position.</param>
+		void SetTile(size_t tile, const Canvas& image)
+		{
+			const Region& region = Tiles_[tile];
+			for (int y = region.Y; y < region.Bottom(); ++y)
+			{
+				for (int x = region.X; x < region.Right(); ++x)
+				{
+					Tuple colour = image.GetPixel(x, y);
+					float* pixel = GetPixel(x, y);
+					pixel[0] = colour.X;
+					pixel[1] = colour.Y;
+					pixel[2] = colour.Z;
+				}
+			}
+
+			std::vector<size_t> committing;
+			{
+				std::lock_guard lock(Mutex_);
+				Pending_.push_back(tile);
+				if (std::chrono::steady_clock::now() - LastCommit_ >= Interval) { committing = TakePendingLocked(); }
+			}
+
+			CommitTiles(committing);
+		}
+
+		/// <summary>
+		/// Marks every tile set so far done, once their pixels are safely on disk.
+		/// </summary>
+		void Commit()
+		{
+			std::vector<size_t> committing;
+			{
+				std::lock_guard lock(Mutex_);
+				committing = TakePendingLocked();
+			}
+
+			CommitTiles(committing);
+		}
+
+		/// <summary>
+		/// Copies the committed tiles' pixels into the image, leaving the pixels of others as they are.
+		/// </summary>
+		void Restore(Canvas& image) const
+		{
+			for (size_t tile = 0; tile < Tiles_.size(); ++tile)
+			{
+				if (!IsTileDone(tile)) { continue; }
+
+				const Region& region = Tiles_[tile];
+				for (int y = region.Y; y < region.Bottom(); ++y)
+				{
+					for (int x = region.X; x < region.Right(); ++x)
+					{
+						const float* pixel = GetPixel(x, y);
+						image.SetPixel(x, y, Tuple::Colour(pixel[0], pixel[1], pixel[2]));
+					}
+				}
+			}
+		}
+
+	private:
+		uint8_t* GetFlags() const { return reinterpret_cast<uint8_t*>(File_.GetData() + FlagsOffset_); }
+
+		float* GetPixel(int x, int y) const
+		{
+			float* pixels = reinterpret_cast<float*>(File_.GetData() + PixelsOffset_);
+			return pixels + (static_cast<size_t>(y) * Width_ + x) * 3;
+		}
+
+		std::vector<size_t> TakePendingLocked()
+		{
+			LastCommit_ = std::chrono::steady_clock::now();
+			return std::exchange(Pending_, {});
+		}
+
+		/// <summary>
+		/// Called without the lock, so other threads carry on setting tiles while the syncs wait for the disk. Each
+		/// tile's pixels were written before it was pending, so are covered by this sync of the pixels even if
+		/// another commit is running at the same time.
+		/// </summary>
+		void CommitTiles(const std::vector<size_t>& tiles)
+		{
+			if (tiles.empty()) { return; }
+
+			TraceScope trace("Checkpoint");
+
+			// Syncing only dirty pages, so this costs what's been written since the last commit.
+			File_.Sync(PixelsOffset_, File_.GetSize() - PixelsOffset_);
+			for (size_t tile : tiles) { GetFlags()[tile] = 1; }
+			File_.Sync(FlagsOffset_, Tiles_.size());
+
+			DoneCount_ += tiles.size();
+		}
+	};
+}
@@ -0,0 +1,226 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+export module RayTracer:Daemon;
+
+import :Camera;
+import :Canvas;
+import :Matrix;
+import :Scene;
+import :Socket;
+import :ThreadPool;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A long running process which keeps scenes loaded, their acceleration structures and caches built, so that
+	/// rendering one again costs only the ray tracing. Listens on a Unix domain socket, "unix:/path", for one request
+	/// per connection, sent and answered as a single string:\n
+	/// load SCENE FILE\n
+	/// unload SCENE\n
+	/// render SCENE OUTPUT WIDTH HEIGHT [FIELD_OF_VIEW FROM_X FROM_Y FROM_Z TO_X TO_Y TO_Z UP_X UP_Y UP_Z]\n
+	/// stop\n
+	/// Renders without a camera use the scene's own view. Answers start with "ok", followed by the render time in
+	/// milliseconds for renders, or "error" followed by what went wrong. Each connection is served on its own thread,
+	/// with every render sharing the one thread pool.\n
+	/// Requests name files to read and write, so the daemon only listens where the file system's permissions decide
+	/// who can connect, never on the network.
+	/// </summary>
+	export class RenderDaemon
+	{
+		Socket Listener_;
+
+		ThreadPool& ThreadPool_;
+
+		// Scenes are never changed once loaded, only replaced, so renders hold on to the one they started with.
+		std::map<std::string, std::shared_ptr<const Scene>> Scenes_;
+
+		std::mutex ScenesMutex_;
+
+		std::atomic<bool> IsStopping_ = false;
+
+	public:
+		// Longest request accepted. Requests are a single line, so anything longer isn't one.
+		static constexpr unsigned long long MaxRequestSize = 64 * 1024;
+
+		/// <param name="address">A Unix domain socket, "unix:/path". Anything else throws.</param>
+		explicit RenderDaemon(const std::string& address, ThreadPool& threadPool = ThreadPool::Shared()) :
+			Listener_(Socket::Listen(CheckAddress(address))), ThreadPool_(threadPool) {}
+
+		RenderDaemon(const RenderDaemon&) = delete;
+
+		RenderDaemon& operator=(const RenderDaemon&) = delete;
+
+		/// <summary>
+		/// Serves requests until asked to stop, then waits for any still being served.
+		/// </summary>
+		void Run()
+		{
+			struct Connection
+			{
+				std::shared_ptr<std::atomic<bool>> IsDone = std::make_shared<std::atomic<bool>>(false);
+
+				std::jthread Thread;
+			};
+
+			// Joined as they're erased, finished ones as new connections arrive and the rest once stopping.
+			std::vector<Connection> connections;
+			while (!IsStopping_)
+			{
+				if (Socket::WaitReadable({&Listener_}, 100).empty()) { continue; }
+
+				std::erase_if(connections, [](const Connection& connection) { return connection.IsDone->load(); });
+				Connection& connection = connections.emplace_back();
+				connection.Thread = std::jthread([this, socket = Listener_.Accept(), isDone = connection.IsDone]
+				{
+					Serve(socket);
+					*isDone = true;
+				});
+			}
+		}
+
+		/// <summary>
+		/// Sends a request to the daemon at the address and waits for its answer.
+		/// </summary>
+		static std::string Request(const std::string& address, const std::string& request)
+		{
+			Socket socket = Socket::Connect(address);
+			socket.SendString(request);
+
+			std::string answer;
+			if (!socket.ReceiveString(answer)) { throw std::runtime_error("Render daemon closed the connection"); }
+
+			return answer;
+		}
+
+		/// <returns>The answer to the request, which is carried out on the calling thread.</returns>
+		std::string Handle(const std::string& request)
+		{
+			std::istringstream stream(request);
+			std::string command;
+			stream >> command;
+
+			try
+			{
+				if (command == "load") { return Load(stream); }
+				if (command == "unload") { return Unload(stream); }
+				if (command == "render") { return Render(stream); }
+				if (command == "stop")
+				{
+					IsStopping_ = true;
+					return "ok";
+				}
+
+				return "error unknown command " + command;
+			}
+			catch (const std::exception& exception) { return std::string("error ") + exception.what(); }
+		}
+
+	private:
+		void Serve(const Socket& socket)
+		{
+			try
+			{
+				std::string request;
+				if (socket.ReceiveString(request, MaxRequestSize)) { socket.SendString(Handle(request)); }
+			}
+			catch (const std::exception&)
+			{
+				// The client went away before its answer, or sent something that isn't a request. Either way only
+				// this connection is affected, nothing else depends on it.
+			}
+		}
+
+		static const std::string& CheckAddress(const std::string& address)
+		{
+			if (!address.starts_with(Socket::UnixPrefix))
+			{
+				throw std::runtime_error("Render daemon only listens on Unix domain sockets, not " + address);
+			}
+
+			return address;
+		}
+
+		std::string Load(std::istream& request)
+		{
+			std::string id, path;
+			if (!(request >> id >> path)) { return "error load needs a scene id and file"; }
+
+			std::ifstream file(path);
+			if (!file) { return "error couldn't open " + path; }
+
+			// Built and prepared fully before anyone can render it, so that renders only ever read it.
+			std::shared_ptr<Scene> scene = std::make_shared<Scene>(Scene::Read(file));
+			scene->World_.BuildAccelerationStructure();
+			scene->World_.Prepare();
+
+			std::lock_guard lock(ScenesMutex_);
+			Scenes_[id] = std::move(scene);
+			return "ok";
+		}
+
+		std::string Unload(std::istream& request)
+		{
+			std::string id;
+			request >> id;
+
+			std::lock_guard lock(ScenesMutex_);
+			return Scenes_.erase(id) ? "ok" : "error no scene " + id;
+		}
+
+		std::string Render(std::istream& request)
+		{
+			std::string id, path;
+			int width = 0, height = 0;
+			if (!(request >> id >> path >> width >> height) || width <= 0 || height <= 0)
+			{
+				return "error render needs a scene id, output file, width and height";
+			}
+
+			std::shared_ptr<const Scene> scene;
+			{
+				std::lock_guard lock(ScenesMutex_);
+				auto found = Scenes_.find(id);
+				if (found == Scenes_.end()) { return "error no scene " + id; }
+				scene = found->second;
+			}
+
+			Camera camera(width, height, scene->Camera_.FieldOfView, scene->Camera_.Transform);
+			camera.Settings = scene->Camera_.Settings;
+
+			float fieldOfView;
+			if (request >> fieldOfView)
+			{
+				float values[9];
+				for (float& value : values)
+				{
+					if (!(request >> value)) { return "error camera needs a field of view, from, to and up"; }
+				}
+
+				camera = Camera(width, height, fieldOfView,
+				                Matrix<4>::ViewTransform(Tuple::Point(values[0], values[1], values[2]),
+				                                         Tuple::Point(values[3], values[4], values[5]),
+				                                         Tuple::Vector(values[6], values[7], values[8])));
+				camera.Settings = scene->Camera_.Settings;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			Canvas image = camera.RenderPrepared(scene->World_, ThreadPool_);
+			auto end = std::chrono::steady_clock::now();
+
+			image.WritePPM(path);
+			return "ok " + std::to_string(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+	};
+}
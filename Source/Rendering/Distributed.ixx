@@ -0,0 +1,351 @@
+module;
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+export module RayTracer:Distributed;
+
+import :Camera;
+import :Canvas;
+import :Scene;
+import :Socket;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// The rectangle of pixels a worker is asked to render. The same message comes back in front of the pixels so the
+	/// coordinator knows where they belong, and a message with no width tells the worker there's no more work.
+	/// Sent as raw bytes, so coordinator and workers must share an architecture.
+	/// </summary>
+	struct TileMessage
+	{
+		std::int32_t X;
+
+		std::int32_t Y;
+
+		std::int32_t Width;
+
+		std::int32_t Height;
+	};
+
+	/// <summary>
+	/// Renders tiles for a Coordinator. Connects to the coordinator, receives the scene, then renders and sends back
+	/// tiles until told to stop.
+	/// </summary>
+	export class Worker
+	{
+	public:
+		static void Run(const std::string& address)
+		{
+			Socket socket = Socket::Connect(address);
+
+			std::string sceneText;
+			if (!socket.ReceiveString(sceneText)) { return; }
+			std::istringstream sceneStream(sceneText);
+			Scene scene = Scene::Read(sceneStream);
+
+			std::vector<float> pixels;
+			TileMessage tile;
+			while (socket.ReceiveValue(tile) && tile.Width > 0)
+			{
+				Canvas image = scene.Camera_.Render(scene.World_, {tile.X, tile.Y, tile.Width, tile.Height});
+
+				pixels.clear();
+				for (const Tuple& colour : image.GetPixels())
+				{
+					pixels.insert(pixels.end(), {colour.X, colour.Y, colour.Z});
+				}
+
+				try
+				{
+					socket.SendValue(tile);
+					socket.Send(pixels.data(), pixels.size() * sizeof(float));
+				}
+				catch (const std::runtime_error&)
+				{
+					// The coordinator has gone, most likely because another worker finished the frame first.
+					return;
+				}
+			}
+		}
+	};
+
+	/// <summary>
+	/// Splits a render into tiles and hands them out to workers connected over a socket, assembling the tiles they
+	/// send back into the final image.\n
+	/// Workers are given one tile at a time, so faster workers naturally take more of the frame. Once every tile has
+	/// been handed out, idle workers duplicate the tiles that have been outstanding longest so a slow worker can't hold
+	/// up the frame, with whichever copy arrives first being used. A worker that disconnects, or takes longer than
+	/// TileTimeout over a tile, is dropped and has its tile handed to another worker. Tiles are read as they arrive
+	/// rather than waited for, so a worker that stops part way through sending one is dropped the same way.
+	/// </summary>
+	export class Coordinator
+	{
+		struct Connection
+		{
+			Socket Socket_;
+
+			std::optional<size_t> Tile;
+
+			// When the tile has to be back by.
+			std::chrono::steady_clock::time_point Deadline;
+
+			// What's arrived so far of the message being received, a tile followed by its pixels.
+			std::vector<char> Received;
+
+			// How long the message will be, only the tile until that's arrived and says how many pixels follow.
+			size_t MessageSize = sizeof(TileMessage);
+		};
+
+		std::string Address_;
+
+		Socket Listener_;
+
+		std::vector<int> ChildProcesses_;
+
+	public:
+		// How long to wait without any connected workers before giving up on a render.
+		std::chrono::milliseconds WorkerTimeout{10000};
+
+		// How long a worker has to return a tile before it's assumed to have hung and is disconnected.
+		std::chrono::milliseconds TileTimeout{60000};
+
+		/// <summary>
+		/// Starts listening for workers on the address, either "unix:/path" or "host:port". TCP listens on
+		/// loopback unless given a host, see Socket.
+		/// </summary>
+		explicit Coordinator(const std::string& address) : Address_(address), Listener_(Socket::Listen(address)) {}
+
+		Coordinator(const Coordinator&) = delete;
+
+		Coordinator& operator=(const Coordinator&) = delete;
+
+		~Coordinator()
+		{
+#if !defined(_WIN32)
+			for (int child : ChildProcesses_)
+			{
+				::kill(child, SIGTERM);
+				::waitpid(child, nullptr, 0);
+			}
+#endif
+		}
+
+		/// <summary>
+		/// Starts worker processes on this machine by running the executable with "--worker address".
+		/// </summary>
+		void SpawnLocalWorkers(const std::string& executable, int count)
+		{
+#if !defined(_WIN32)
+			for (int i = 0; i < count; ++i)
+			{
+				int child = ::fork();
+				if (child < 0) { throw std::runtime_error("Coordinator failed to fork a worker."); }
+				if (child == 0)
+				{
+					::execl(executable.c_str(), executable.c_str(), "--worker", Address_.c_str(), nullptr);
+					::_exit(127);
+				}
+
+				ChildProcesses_.push_back(child);
+			}
+#else
+			throw std::runtime_error("Spawning workers requires a POSIX system.");
+#endif
+		}
+
+		Canvas Render(const Scene& scene, int tileSize = 32)
+		{
+			const Camera& camera = scene.Camera_;
+
+			std::ostringstream sceneStream;
+			scene.Write(sceneStream);
+			const std::string sceneText = sceneStream.str();
+
+			std::vector<TileMessage> tiles;
+			for (const Region& tile : camera.GetRegion().Tiles(tileSize))
+			{
+				tiles.push_back({tile.X, tile.Y, tile.Width, tile.Height});
+			}
+
+			Canvas image(camera.RenderWidth, camera.RenderHeight);
+
+			std::deque<size_t> pending;
+			for (size_t i = 0; i < tiles.size(); ++i) { pending.push_back(i); }
+
+			// Tiles handed out but not yet returned, oldest first.
+			std::deque<size_t> inFlight;
+			std::vector<bool> done(tiles.size(), false);
+			size_t remaining = tiles.size();
+
+			std::vector<Connection> workers;
+			std::vector<float> pixels;
+			auto lastWorkerSeen = std::chrono::steady_clock::now();
+
+			// Hands a connection its next tile, preferring tiles nobody has, then duplicating the oldest outstanding.
+			auto assign = [&](Connection& worker)
+			{
+				worker.Tile.reset();
+				std::erase_if(inFlight, [&](size_t tile) { return done[tile]; });
+
+				if (!pending.empty())
+				{
+					worker.Tile = pending.front();
+					pending.pop_front();
+					inFlight.push_back(*worker.Tile);
+				}
+				else if (!inFlight.empty())
+				{
+					worker.Tile = inFlight.front();
+					inFlight.pop_front();
+					inFlight.push_back(*worker.Tile);
+				}
+
+				if (worker.Tile)
+				{
+					worker.Deadline = std::chrono::steady_clock::now() + TileTimeout;
+					worker.Socket_.SendValue(tiles[*worker.Tile]);
+				}
+			};
+
+			// A disconnected worker's tile goes back to the front of the queue unless someone else finished it.
+			auto drop = [&](Connection& worker)
+			{
+				if (worker.Tile && !done[*worker.Tile])
+				{
+					std::erase(inFlight, *worker.Tile);
+					pending.push_front(*worker.Tile);
+				}
+				worker.Tile.reset();
+				worker.Socket_.Close();
+			};
+
+			while (remaining > 0)
+			{
+				std::vector<const Socket*> sockets{&Listener_};
+				for (const Connection& worker : workers) { sockets.push_back(&worker.Socket_); }
+
+				for (size_t ready : Socket::WaitReadable(sockets, 100))
+				{
+					if (ready == 0)
+					{
+						Connection* worker = nullptr;
+						try
+						{
+							worker = &workers.emplace_back(Listener_.Accept());
+
+							// So that a worker that stops reading can't hold up the coordinator either.
+							worker->Socket_.SetSendTimeout(TileTimeout);
+							worker->Socket_.SendString(sceneText);
+							assign(*worker);
+						}
+						catch (const std::runtime_error&)
+						{
+							if (worker) { drop(*worker); }
+						}
+						continue;
+					}
+
+					Connection& worker = workers[ready - 1];
+					try
+					{
+						size_t received = worker.Received.size();
+						worker.Received.resize(worker.MessageSize);
+						std::optional<size_t> count = worker.Socket_.ReceiveAvailable(worker.Received.data() + received,
+						                                                              worker.MessageSize - received);
+						if (!count)
+						{
+							drop(worker);
+							continue;
+						}
+
+						worker.Received.resize(received + *count);
+						if (worker.Received.size() < worker.MessageSize) { continue; }
+
+						TileMessage tile;
+						std::memcpy(&tile, worker.Received.data(), sizeof(TileMessage));
+						if (worker.MessageSize == sizeof(TileMessage))
+						{
+							// Only the tile the worker was given, which bounds how many pixels can follow.
+							if (!worker.Tile || !IsSameTile(tile, tiles[*worker.Tile]))
+							{
+								drop(worker);
+								continue;
+							}
+
+							worker.MessageSize += static_cast<size_t>(tile.Width) * tile.Height * 3 * sizeof(float);
+							continue;
+						}
+
+						pixels.resize(static_cast<size_t>(tile.Width) * tile.Height * 3);
+						std::memcpy(pixels.data(), worker.Received.data() + sizeof(TileMessage),
+						            pixels.size() * sizeof(float));
+						worker.Received.clear();
+						worker.MessageSize = sizeof(TileMessage);
+
+						if (!done[*worker.Tile])
+						{
+							for (int y = 0; y < tile.Height; ++y)
+							{
+								for (int x = 0; x < tile.Width; ++x)
+								{
+									const float* pixel = &pixels[(static_cast<size_t>(y) * tile.Width + x) * 3];
+									image.SetPixel(tile.X + x, tile.Y + y,
+									               Tuple::Colour(pixel[0], pixel[1], pixel[2]));
+								}
+							}
+
+							done[*worker.Tile] = true;
+							--remaining;
+						}
+
+						if (remaining > 0) { assign(worker); }
+					}
+					catch (const std::runtime_error&) { drop(worker); }
+				}
+
+				auto now = std::chrono::steady_clock::now();
+				for (Connection& worker : workers)
+				{
+					if (worker.Tile && !done[*worker.Tile] && now > worker.Deadline) { drop(worker); }
+				}
+
+				std::erase_if(workers, [](const Connection& worker) { return !worker.Socket_.IsOpen(); });
+
+				if (!workers.empty()) { lastWorkerSeen = now; }
+				else if (now - lastWorkerSeen > WorkerTimeout)
+				{
+					throw std::runtime_error("Coordinator has no workers left to render the remaining tiles.");
+				}
+			}
+
+			// Tell everyone still connected that the frame is finished.
+			for (Connection& worker : workers)
+			{
+				try { worker.Socket_.SendValue(TileMessage{0, 0, 0, 0}); }
+				catch (const std::runtime_error&) {}
+			}
+
+			return image;
+		}
+
+	private:
+		static bool IsSameTile(const TileMessage& lhs, const TileMessage& rhs)
+		{
+			return lhs.X == rhs.X && lhs.Y == rhs.Y && lhs.Width == rhs.Width && lhs.Height == rhs.Height;
+		}
+	};
+}
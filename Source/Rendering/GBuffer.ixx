@@ -0,0 +1,54 @@
+module;
+#include <cassert>
+#include <optional>
+#include <vector>
+
+export module RayTracer:GBuffer;
+
+import :Memory;
+import :Shape;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// The primary hit of every pixel from a render, everything PrepareComputations works out about where a camera
+	/// ray first hits the world. Only shading depends on materials and the light, so after changing either the
+	/// image can be shaded again from these without finding the hits again. Moving the camera or any object makes it
+	/// out of date.
+	/// </summary>
+	export class GBuffer
+	{
+		int Width_ = 0;
+
+		int Height_ = 0;
+
+		// Empty where the camera ray hit nothing.
+		std::vector<std::optional<Shape::Computation>> Hits_;
+
+		TrackedBytes Memory_{MemoryCategory::Framebuffers};
+
+	public:
+		GBuffer() = default;
+
+		GBuffer(int width, int height) : Width_(width), Height_(height), Hits_(width * height)
+		{
+			Memory_.Set(Hits_.capacity() * sizeof(Hits_[0]));
+		}
+
+		int GetWidth() const { return Width_; }
+
+		int GetHeight() const { return Height_; }
+
+		const std::optional<Shape::Computation>& GetHit(int x, int y) const
+		{
+			assert(x >= 0 && x < Width_ && y >= 0 && y < Height_);
+			return Hits_[Width_ * y + x];
+		}
+
+		void SetHit(int x, int y, const std::optional<Shape::Computation>& hit)
+		{
+			assert(x >= 0 && x < Width_ && y >= 0 && y < Height_);
+			Hits_[Width_ * y + x] = hit;
+		}
+	};
+}
@@ -1,7 +1,6 @@
 module;
 #include <cassert>
 #include <cmath>
-#include <memory>
 #include <optional>
 export module RayTracer:Material;
 
@@ -26,7 +25,8 @@ namespace RayTracer
 
 		float Reflectiveness = 0.0f;
 
-		std::shared_ptr<Pattern> Pattern_;
+		// Not owned by the material, patterns belong to whatever made them, normally a world's storage.
+		const Pattern* Pattern_ = nullptr;
 
 		/// <returns>The colour of the surface at the specified point.</returns>
 		Tuple Lighting(const PointLight& light, const Tuple& surfacePointViewed,
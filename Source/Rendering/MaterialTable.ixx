@@ -0,0 +1,110 @@
+module;
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+export module RayTracer:MaterialTable;
+
+import :Material;
+import :Memory;
+import :Shading;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Every distinct material in a world stored once, one after another, for shapes to refer to by index. Scenes
+	/// tend to reuse a handful of materials across many shapes, so shading from here keeps to a small array rather
+	/// than reading a copy from every shape hit. Each material's shading kernel is chosen as it's added.
+	/// </summary>
+	export class MaterialTable
+	{
+		std::vector<Material> Materials_;
+
+		std::vector<ShadingKernel> Kernels_;
+
+		// Indices of the materials by hash, to find an existing identical material when adding.
+		std::unordered_multimap<size_t, uint32_t> Lookup_;
+
+		TrackedBytes Memory_{MemoryCategory::SceneObjects};
+
+	public:
+		// Where every table keeps the default material, which shapes have until they're given another.
+		static constexpr uint32_t DefaultIndex = 0;
+
+		MaterialTable() { Add(Material{}); }
+
+		/// <returns>The index of a material identical to the one given, which is added if there isn't one.</returns>
+		uint32_t Add(const Material& material)
+		{
+			size_t hash = Hash(material);
+			auto [first, last] = Lookup_.equal_range(hash);
+			for (auto entry = first; entry != last; ++entry)
+			{
+				if (IsIdentical(Materials_[entry->second], material)) { return entry->second; }
+			}
+
+			uint32_t index = static_cast<uint32_t>(Materials_.size());
+			Materials_.push_back(material);
+			Kernels_.push_back(SelectShadingKernel(material));
+			Lookup_.emplace(hash, index);
+			UpdateMemory();
+
+			return index;
+		}
+
+		/// <returns>Whether the index refers to a material identical to the one given.</returns>
+		bool Contains(uint32_t index, const Material& material) const
+		{
+			return index < Materials_.size() && IsIdentical(Materials_[index], material);
+		}
+
+		const Material& operator[](uint32_t index) const
+		{
+			assert(index < Materials_.size());
+			return Materials_[index];
+		}
+
+		ShadingKernel GetKernel(uint32_t index) const
+		{
+			assert(index < Kernels_.size());
+			return Kernels_[index];
+		}
+
+		size_t GetSize() const { return Materials_.size(); }
+
+		/// <summary>
+		/// Exact comparison, unlike Material's operator== which allows for rounding and ignores colour and pattern,
+		/// as only materials that shade exactly the same can share an entry.
+		/// </summary>
+		static bool IsIdentical(const Material& lhs, const Material& rhs)
+		{
+			return lhs.Colour.X == rhs.Colour.X && lhs.Colour.Y == rhs.Colour.Y && lhs.Colour.Z == rhs.Colour.Z &&
+				lhs.Colour.W == rhs.Colour.W && lhs.Ambient == rhs.Ambient && lhs.Diffuse == rhs.Diffuse &&
+				lhs.Specular == rhs.Specular && lhs.Shininess == rhs.Shininess &&
+				lhs.Reflectiveness == rhs.Reflectiveness && lhs.Pattern_ == rhs.Pattern_;
+		}
+
+	private:
+		void UpdateMemory()
+		{
+			Memory_.Set(Materials_.capacity() * sizeof(Material) + Kernels_.capacity() * sizeof(ShadingKernel));
+		}
+
+		static size_t Hash(const Material& material)
+		{
+			size_t hash = std::hash<const void*>{}(material.Pattern_);
+			for (float value : {material.Colour.X, material.Colour.Y, material.Colour.Z, material.Colour.W,
+			                    material.Ambient, material.Diffuse, material.Specular, material.Shininess,
+			                    material.Reflectiveness})
+			{
+				hash = hash * 31 + std::bit_cast<uint32_t>(value);
+			}
+
+			return hash;
+		}
+	};
+}
@@ -0,0 +1,210 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+export module RayTracer:MultiProcess;
+
+import :Camera;
+import :Canvas;
+import :MappedFile;
+import :Trace;
+import :Tuple;
+import :World;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A child process that didn't exit cleanly from rendering.
+	/// </summary>
+	export struct ProcessFailure
+	{
+		int ProcessID;
+
+		// The child's exit status if it exited, which is 1 for an exception.
+		int ExitStatus = 0;
+
+		// The signal that ended the child, if one did.
+		int Signal = 0;
+
+		// Whether the child was still running at the timeout, and so was killed.
+		bool IsTimedOut = false;
+
+		/// <returns>What happened to the child, for reporting.</returns>
+		std::string Describe() const
+		{
+			std::string process = "Render process " + std::to_string(ProcessID);
+			if (IsTimedOut) { return process + " timed out and was killed"; }
+			if (Signal != 0) { return process + " was killed by signal " + std::to_string(Signal); }
+
+			return process + " exited with status " + std::to_string(ExitStatus);
+		}
+	};
+
+	/// <summary>
+	/// Renders across child processes forked from this one, which each render tiles of the same world straight into a
+	/// framebuffer in POSIX shared memory, without any copying or serialisation between them. Processes take tiles
+	/// from a shared counter, so faster ones take more. Tiles left undone by a child that dies are rendered by the
+	/// parent afterwards, as are those of children still running at the timeout, which are killed, so a failure in
+	/// one process costs time rather than the image. Each child renders on a single thread, as the parent's threads
+	/// don't survive forking.
+	/// </summary>
+	export class MultiProcessRenderer
+	{
+		struct Header
+		{
+			std::atomic<uint32_t> NextTile;
+		};
+
+		static_assert(std::atomic<uint32_t>::is_always_lock_free, "Atomics in shared memory must be lock free.");
+
+		int ProcessCount_;
+
+		std::vector<ProcessFailure> Failures_;
+
+	public:
+		// How long children have to finish the render before they're assumed to have hung and are killed.
+		std::chrono::milliseconds Timeout{600000};
+
+		explicit MultiProcessRenderer(int processCount) : ProcessCount_(processCount) {}
+
+		/// <returns>The children of the last render that didn't exit cleanly, and what happened to them.</returns>
+		const std::vector<ProcessFailure>& GetFailures() const { return Failures_; }
+
+		Canvas Render(const Camera& camera, const World& world)
+		{
+#if !defined(_WIN32)
+			TraceScope trace("Render in processes");
+			Failures_.clear();
+
+			// Brought up to date before forking, so that the children don't each repeat it.
+			world.Prepare();
+			camera.Prepare();
+
+			std::vector<Region> tiles = camera.GetRegion().Tiles(Camera::TileSize);
+			size_t doneOffset = sizeof(Header);
+			size_t pixelsOffset = (doneOffset + tiles.size() + alignof(float) - 1) / alignof(float) * alignof(float);
+			size_t pixelCount = static_cast<size_t>(camera.RenderWidth) * camera.RenderHeight;
+			size_t size = pixelsOffset + pixelCount * 3 * sizeof(float);
+
+			static std::atomic<int> renders = 0;
+			std::string name = "/RayTracer-" + std::to_string(::getpid()) + "-" + std::to_string(renders++);
+			MappedFile framebuffer = MappedFile::OpenShared(name, size);
+
+			// The mapping stays for as long as anything has it mapped, children included.
+			MappedFile::UnlinkShared(name);
+
+			std::byte* memory = framebuffer.GetData();
+			Header& header = *new(memory) Header{0};
+			auto* done = reinterpret_cast<std::atomic<uint8_t>*>(memory + doneOffset);
+			for (size_t tile = 0; tile < tiles.size(); ++tile) { new(&done[tile]) std::atomic<uint8_t>(0); }
+			float* pixels = reinterpret_cast<float*>(memory + pixelsOffset);
+
+			auto renderTiles = [&]
+			{
+				for (uint32_t tile = header.NextTile++; tile < tiles.size(); tile = header.NextTile++)
+				{
+					camera.Render(world, tiles[tile], pixels);
+					done[tile].store(1, std::memory_order_release);
+				}
+			};
+
+			std::vector<pid_t> children;
+			for (int i = 0; i < ProcessCount_; ++i)
+			{
+				pid_t child = ::fork();
+				if (child < 0) { break; }
+				if (child == 0)
+				{
+					int status = 0;
+					try { renderTiles(); }
+					catch (...) { status = 1; }
+
+					// Skips destructors and atexit handlers, which belong to the parent.
+					::_exit(status);
+				}
+
+				children.push_back(child);
+			}
+
+			WaitForChildren(children);
+
+			// Picks up any tiles of children that died, or all of them if none could be started.
+			for (size_t tile = 0; tile < tiles.size(); ++tile)
+			{
+				if (!done[tile].load(std::memory_order_acquire)) { camera.Render(world, tiles[tile], pixels); }
+			}
+
+			TraceScope writeTrace("Copy framebuffer");
+			Canvas image(camera.RenderWidth, camera.RenderHeight);
+			for (int y = 0; y < camera.RenderHeight; ++y)
+			{
+				for (int x = 0; x < camera.RenderWidth; ++x)
+				{
+					const float* pixel = pixels + (static_cast<size_t>(y) * camera.RenderWidth + x) * 3;
+					image.SetPixel(x, y, Tuple::Colour(pixel[0], pixel[1], pixel[2]));
+				}
+			}
+
+			return image;
+#else
+			throw std::runtime_error("Rendering in processes requires a POSIX system.");
+#endif
+		}
+
+	private:
+#if !defined(_WIN32)
+		/// <summary>
+		/// Waits for every child to exit, recording any that fail, until the timeout, when those left are killed.
+		/// </summary>
+		void WaitForChildren(std::vector<pid_t> children)
+		{
+			auto deadline = std::chrono::steady_clock::now() + Timeout;
+			while (!children.empty())
+			{
+				std::erase_if(children, [&](pid_t child)
+				{
+					int status = 0;
+					pid_t result = ::waitpid(child, &status, WNOHANG);
+					if (result == 0) { return false; }
+
+					// Reaped by something else, such as a SIGCHLD handler, so how it ended is unknown.
+					if (result < 0) { Failures_.push_back({child, -1}); }
+					else if (WIFSIGNALED(status)) { Failures_.push_back({child, 0, WTERMSIG(status)}); }
+					else if (WEXITSTATUS(status) != 0) { Failures_.push_back({child, WEXITSTATUS(status)}); }
+
+					return true;
+				});
+
+				if (children.empty()) { break; }
+
+				if (std::chrono::steady_clock::now() >= deadline)
+				{
+					for (pid_t child : children)
+					{
+						::kill(child, SIGKILL);
+						::waitpid(child, nullptr, 0);
+						Failures_.push_back({child, 0, SIGKILL, true});
+					}
+
+					break;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+#endif
+	};
+}
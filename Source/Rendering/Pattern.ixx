@@ -3,6 +3,7 @@ module;
 export module RayTracer:Pattern;
 
 import :Tuple;
+import :Affine;
 import :Matrix;
 
 namespace RayTracer
@@ -25,9 +26,26 @@ namespace RayTracer
 	public:
 		virtual ~Pattern() = default;
 
-		virtual Tuple ColourAt(Tuple point) = 0;
+		virtual Tuple ColourAt(Tuple point) const = 0;
 
-		Matrix<4> Transform = Matrix<4>::IdentityMatrix();
+		Matrix<4> GetTransform() const { return Transform_.ToMatrix(); }
+
+		/// <summary>
+		/// Moves the pattern on the shapes it's applied to, working out the inverse straight away so that rendering
+		/// only ever reads it.
+		/// </summary>
+		void SetTransform(const Matrix<4>& transform)
+		{
+			Transform_ = Affine::From(transform);
+			InverseTransform_ = Transform_.Inverted();
+		}
+
+		const Affine& InverseTransform() const { return InverseTransform_; }
+
+	private:
+		Affine Transform_ = Affine::Identity();
+
+		Affine InverseTransform_ = Affine::Identity();
 	};
 
 	export class StripePattern : public Pattern
@@ -39,7 +57,7 @@ namespace RayTracer
 
 		StripePattern(Tuple colourA, Tuple colourB) : ColourA(colourA), ColourB(colourB) {}
 
-		Tuple ColourAt(Tuple point) override
+		Tuple ColourAt(Tuple point) const override
 		{
 			// We need to cast to an integer so that we can check if odd.
 			// But, we can't rely on integer truncating as it'll 
@@ -58,7 +76,7 @@ namespace RayTracer
 
 		GradientPattern(Tuple colourA, Tuple colourB) : ColourA(colourA), ColourB(colourB) {}
 
-		Tuple ColourAt(Tuple point) override
+		Tuple ColourAt(Tuple point) const override
 		{
 			// Offset to get from ColourA to ColourB.
 			Tuple distanceAB = ColourB - ColourA;
@@ -84,7 +102,7 @@ namespace RayTracer
 
 		RingPattern(Tuple colourA, Tuple colourB) : ColourA(colourA), ColourB(colourB) {}
 
-		Tuple ColourAt(Tuple point) override
+		Tuple ColourAt(Tuple point) const override
 		{
 			if ((static_cast<int>(std::floor(std::sqrtf(std::pow(point.X, 2.f) + std::pow(point.Z, 2.f)))) & 1)
 				== 0) { return ColourA; }
@@ -101,7 +119,7 @@ namespace RayTracer
 
 		CheckerPattern(Tuple colourA, Tuple colourB) : ColourA(colourA), ColourB(colourB) {}
 
-		Tuple ColourAt(Tuple point) override
+		Tuple ColourAt(Tuple point) const override
 		{
 			// We need to cast to an integer so that we can check if odd.
 			// But, we can't rely on integer truncating as it'll 
@@ -0,0 +1,282 @@
+module;
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module RayTracer:PostProcess;
+
+import :Canvas;
+import :ThreadPool;
+import :Trace;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// How colours above 1 are brought down into the range a display shows.
+	/// </summary>
+	export enum class ToneMapper
+	{
+		// Left as they are, to be clipped when written.
+		None,
+
+		// c / (1 + c), which never quite reaches white.
+		Reinhard,
+
+		// Narkowicz's fit to the ACES filmic curve, with a toe in the shadows and a shoulder that reaches white.
+		ACES
+	};
+
+	/// <summary>
+	/// How linear colours are encoded for display once tone mapped.
+	/// </summary>
+	export enum class TransferFunction
+	{
+		Linear,
+
+		// A plain power of 1 / Gamma.
+		Gamma,
+
+		// The sRGB curve, linear near black and close to a power of 1 / 2.4 above.
+		SRGB
+	};
+
+	/// <summary>
+	/// How to turn a rendered image, with colours in linear light that may go well above 1, into one ready to
+	/// write out. The defaults change nothing, leaving colours to be clipped as they always have been.
+	/// </summary>
+	export struct PostProcessSettings
+	{
+		// In stops, so each 1 doubles the brightness. Applied before anything else.
+		float Exposure = 0;
+
+		ToneMapper ToneMap = ToneMapper::None;
+
+		TransferFunction Transfer = TransferFunction::Linear;
+
+		// Only used by TransferFunction::Gamma.
+		float Gamma = 2.2f;
+
+		// How much of the light above BloomThreshold spreads out around bright pixels. 0 turns bloom off.
+		float BloomStrength = 0;
+
+		// Brightness, after exposure, above which pixels glow.
+		float BloomThreshold = 1;
+
+		// How far the glow spreads, in pixels.
+		int BloomRadius = 8;
+
+		// Adds an 8 by 8 ordered dither of under half a step of the 8 bit output to every pixel, breaking up the
+		// bands smooth gradients get when written.
+		bool Dither = false;
+
+		bool operator==(const PostProcessSettings&) const = default;
+	};
+
+	// Exposure, bloom, tone mapping, encoding and dithering of one row of pixels, in place.
+	using GradeKernel = void (*)(std::span<Tuple> row, std::span<const Tuple> bloom, int y,
+	                             const PostProcessSettings& settings, float scale);
+
+	// Thresholds 0 to 63 spread as evenly as possible over every 8 by 8 square.
+	constexpr std::array<std::array<int, 8>, 8> BayerMatrix{{
+		{0, 32, 8, 40, 2, 34, 10, 42},
+		{48, 16, 56, 24, 50, 18, 58, 26},
+		{12, 44, 4, 36, 14, 46, 6, 38},
+		{60, 28, 52, 20, 62, 30, 54, 22},
+		{3, 35, 11, 43, 1, 33, 9, 41},
+		{51, 19, 59, 27, 49, 17, 57, 25},
+		{15, 47, 7, 39, 13, 45, 5, 37},
+		{63, 31, 55, 23, 61, 29, 53, 21}
+	}};
+
+	template <ToneMapper Mapper>
+	float MapTone(float value)
+	{
+		if constexpr (Mapper == ToneMapper::Reinhard)
+		{
+			value = std::max(value, 0.0f);
+			return value / (1 + value);
+		}
+		else if constexpr (Mapper == ToneMapper::ACES)
+		{
+			value = std::max(value, 0.0f);
+			return std::clamp(value * (2.51f * value + 0.03f) / (value * (2.43f * value + 0.59f) + 0.14f), 0.0f, 1.0f);
+		}
+		else { return value; }
+	}
+
+	template <TransferFunction Transfer>
+	float Encode(float value, float inverseGamma)
+	{
+		if constexpr (Transfer == TransferFunction::Gamma) { return std::pow(std::max(value, 0.0f), inverseGamma); }
+		else if constexpr (Transfer == TransferFunction::SRGB)
+		{
+			value = std::max(value, 0.0f);
+			return value <= 0.0031308f ? 12.92f * value : 1.055f * std::pow(value, 1 / 2.4f) - 0.055f;
+		}
+		else { return value; }
+	}
+
+	/// <summary>
+	/// Every stage after bloom in a single pass, with whatever the settings don't use compiled out, so that the
+	/// loop over the row has no branches on the settings and is left for the compiler to vectorise.
+	/// </summary>
+	template <ToneMapper Mapper, TransferFunction Transfer, bool HasBloom, bool HasDither>
+	void Grade(std::span<Tuple> row, std::span<const Tuple> bloom, int y, const PostProcessSettings& settings,
+	           float scale)
+	{
+		float inverseGamma = 1 / settings.Gamma;
+		float bloomStrength = settings.BloomStrength;
+		const std::array<int, 8>& thresholds = BayerMatrix[y & 7];
+
+		for (size_t x = 0; x < row.size(); ++x)
+		{
+			Tuple colour = row[x] * scale;
+			if constexpr (HasBloom) { colour = colour + bloom[x] * bloomStrength; }
+
+			float dither = 0;
+			if constexpr (HasDither) { dither = ((thresholds[x & 7] + 0.5f) / 64 - 0.5f) / 255; }
+
+			for (float* channel : {&colour.X, &colour.Y, &colour.Z})
+			{
+				*channel = Encode<Transfer>(MapTone<Mapper>(*channel), inverseGamma) + dither;
+			}
+
+			row[x] = colour;
+		}
+	}
+
+	template <size_t... Configurations>
+	constexpr std::array<GradeKernel, sizeof...(Configurations)> MakeGradeKernels(
+		std::index_sequence<Configurations...>)
+	{
+		return {&Grade<static_cast<ToneMapper>(Configurations / 12),
+		               static_cast<TransferFunction>(Configurations / 4 % 3), (Configurations & 2) != 0,
+		               (Configurations & 1) != 0>...};
+	}
+
+	// Indexed by tone mapper, then transfer function, then bloom and dither as bits.
+	constexpr std::array<GradeKernel, 36> GradeKernels = MakeGradeKernels(std::make_index_sequence<36>{});
+
+	/// <summary>
+	/// Grades finished renders for display. Works from the floating point image alone, so a render kept with its
+	/// colours above 1, such as one written as StreamFormat::RawFloat, can be graded again with different settings
+	/// without tracing it again.
+	/// </summary>
+	export class PostProcess
+	{
+	public:
+		// Rows handed to each thread at a time.
+		static constexpr int BandHeight = 16;
+
+		/// <summary>
+		/// Grades the image in at most two passes across the thread pool, a band of rows to each thread at a time.
+		/// With bloom, the first pass picks out and blurs the bright light across each row, and the second blurs it
+		/// down each column as it's added back in. Everything else happens in the last pass, as each pixel's final
+		/// colour is worked out.
+		/// </summary>
+		/// <returns>A graded copy of the image, in the same layout.</returns>
+		static Canvas Apply(const Canvas& image, const PostProcessSettings& settings,
+		                    ThreadPool& threadPool = ThreadPool::Shared())
+		{
+			TraceScope trace("Post-process");
+
+			int width = image.GetWidth(), height = image.GetHeight();
+			float scale = std::exp2(settings.Exposure);
+			bool hasBloom = settings.BloomStrength != 0 && settings.BloomRadius > 0;
+			size_t bands = (height + BandHeight - 1) / BandHeight;
+
+			std::vector<float> weights = hasBloom ? BlurWeights(settings.BloomRadius) : std::vector<float>{};
+			int radius = static_cast<int>(weights.size()) / 2;
+
+			// Bright light blurred across each row, row by row.
+			std::vector<Tuple> bright;
+			if (hasBloom)
+			{
+				TraceScope brightTrace("Bloom");
+				bright.resize(static_cast<size_t>(width) * height);
+				threadPool.ParallelFor(bands, [&](size_t band)
+				{
+					// Padded by repeating the edge pixels, so the blur needs no checks for running off the row.
+					std::vector<Tuple> row(width), padded(width + 2 * radius);
+					int first = static_cast<int>(band) * BandHeight;
+					for (int y = first; y < std::min(height, first + BandHeight); ++y)
+					{
+						image.CopyRow(y, row);
+						for (int x = 0; x < width + 2 * radius; ++x)
+						{
+							padded[x] = BrightPart(row[std::clamp(x - radius, 0, width - 1)] * scale,
+							                       settings.BloomThreshold);
+						}
+
+						// A tap at a time along the whole row, as for the vertical blur.
+						Tuple* blurred = bright.data() + static_cast<size_t>(width) * y;
+						for (int i = 0; i <= 2 * radius; ++i)
+						{
+							float weight = weights[i];
+							for (int x = 0; x < width; ++x) { blurred[x] = blurred[x] + padded[x + i] * weight; }
+						}
+					}
+				});
+			}
+
+			GradeKernel kernel = GradeKernels[static_cast<size_t>(settings.ToneMap) * 12 +
+				static_cast<size_t>(settings.Transfer) * 4 + hasBloom * 2 + settings.Dither];
+
+			Canvas graded(width, height, image.GetLayout());
+			threadPool.ParallelFor(bands, [&](size_t band)
+			{
+				std::vector<Tuple> row(width), bloom(hasBloom ? width : 0);
+				int first = static_cast<int>(band) * BandHeight;
+				for (int y = first; y < std::min(height, first + BandHeight); ++y)
+				{
+					image.CopyRow(y, row);
+					if (hasBloom)
+					{
+						// A row at a time down the column, so the inner loop runs along contiguous memory.
+						std::ranges::fill(bloom, Tuple::Colour(0, 0, 0));
+						for (int i = -radius; i <= radius; ++i)
+						{
+							const Tuple* source = bright.data() + static_cast<size_t>(width) *
+								std::clamp(y + i, 0, height - 1);
+							float weight = weights[i + radius];
+							for (int x = 0; x < width; ++x) { bloom[x] = bloom[x] + source[x] * weight; }
+						}
+					}
+
+					kernel(row, bloom, y, settings, scale);
+					std::ranges::copy(row, graded.Row(y).begin());
+				}
+			});
+
+			return graded;
+		}
+
+	private:
+		/// <returns>How far the colour is above the threshold, in each channel.</returns>
+		static Tuple BrightPart(const Tuple& colour, float threshold)
+		{
+			return Tuple::Colour(std::max(colour.X - threshold, 0.0f), std::max(colour.Y - threshold, 0.0f),
+			                     std::max(colour.Z - threshold, 0.0f));
+		}
+
+		/// <returns>A Gaussian falling to about 1% at the radius either side of the middle, adding up to 1.</returns>
+		static std::vector<float> BlurWeights(int radius)
+		{
+			float sigma = radius / 3.0f;
+			std::vector<float> weights(2 * radius + 1);
+			float total = 0;
+			for (int i = -radius; i <= radius; ++i)
+			{
+				weights[i + radius] = std::exp(-(i * i) / (2 * sigma * sigma));
+				total += weights[i + radius];
+			}
+
+			for (float& weight : weights) { weight /= total; }
+			return weights;
+		}
+	};
+}
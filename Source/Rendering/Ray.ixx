@@ -2,6 +2,7 @@ export module RayTracer:Ray;
 
 import :Tuple;
 import :Matrix;
+import :Affine;
 
 namespace RayTracer
 {
@@ -16,9 +17,14 @@ namespace RayTracer
 			return Origin + Direction * time;
 		}
 
-		Ray Transformed(Matrix<4> matrix) const
+		Ray Transformed(const Matrix<4>& matrix) const
 		{
 			return { matrix * Origin, matrix * Direction };
 		}
+
+		Ray Transformed(const Affine& transform) const
+		{
+			return { transform.TransformPoint(Origin), transform.TransformVector(Direction) };
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+export module RayTracer:RenderJob;
+
+import :Canvas;
+import :ThreadPool;
+import :Trace;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A handle to a render running in the background on a thread pool, a tile at a time, which can be watched,
+	/// cancelled and waited on. Cancelling is checked before every row of pixels, so workers stop within a row's
+	/// render time. Destroying the handle cancels the render and waits for its workers to stop, so that nothing it
+	/// refers to is used after the handle has gone.
+	/// </summary>
+	export class RenderJob
+	{
+	public:
+		// Renders the pixels of the region into the image.
+		using RenderRegion = std::function<void(const Region& region, Canvas& image)>;
+
+		// Called from whichever thread finished the tile, after its pixels are in the image.
+		using TileCallback = std::function<void(const Region& tile)>;
+
+	private:
+		struct State
+		{
+			Canvas Image;
+
+			std::vector<Region> Tiles;
+
+			RenderRegion Render;
+
+			std::atomic<size_t> NextTile = 0;
+
+			std::atomic<size_t> TilesDone = 0;
+
+			std::atomic<bool> IsCancelled = false;
+
+			std::mutex Mutex;
+
+			std::condition_variable Finished;
+
+			// Guarded by the mutex.
+			size_t ActiveWorkers = 0;
+
+			std::vector<TileCallback> Callbacks;
+
+			std::exception_ptr Exception;
+		};
+
+		std::shared_ptr<State> State_;
+
+		explicit RenderJob(std::shared_ptr<State> state) : State_(std::move(state)) {}
+
+	public:
+		/// <summary>
+		/// Starts rendering the tiles into the image across the thread pool, returning straight away.
+		/// </summary>
+		static RenderJob Start(Canvas image, std::vector<Region> tiles, RenderRegion render, ThreadPool& threadPool)
+		{
+			std::shared_ptr<State> state = std::make_shared<State>(std::move(image), std::move(tiles),
+			                                                       std::move(render));
+
+			size_t workers = std::min(threadPool.GetThreadCount(), state->Tiles.size());
+			if (workers == 0) { return RenderJob(state); }
+
+			state->ActiveWorkers = workers;
+			for (size_t i = 0; i < workers; ++i) { threadPool.Submit([state] { Work(*state); }); }
+
+			return RenderJob(state);
+		}
+
+		RenderJob(RenderJob&&) noexcept = default;
+
+		RenderJob& operator=(RenderJob&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Stop();
+				State_ = std::move(other.State_);
+			}
+
+			return *this;
+		}
+
+		~RenderJob() { Stop(); }
+
+		/// <returns>The fraction of tiles finished, from 0 to 1.</returns>
+		float GetProgress() const
+		{
+			if (State_->Tiles.empty()) { return 1; }
+
+			return static_cast<float>(State_->TilesDone.load()) / static_cast<float>(State_->Tiles.size());
+		}
+
+		/// <returns>Whether every worker has stopped, having finished or been cancelled.</returns>
+		bool IsFinished() const
+		{
+			std::lock_guard lock(State_->Mutex);
+			return State_->ActiveWorkers == 0;
+		}
+
+		/// <summary>
+		/// Adds a function to call as each tile is finished from now on. Tiles already finished aren't called
+		/// back for.
+		/// </summary>
+		void OnTileDone(TileCallback callback)
+		{
+			std::lock_guard lock(State_->Mutex);
+			State_->Callbacks.push_back(std::move(callback));
+		}
+
+		/// <summary>
+		/// Asks the workers to stop, without waiting for them to.
+		/// </summary>
+		void Cancel() { State_->IsCancelled.store(true); }
+
+		bool IsCancelled() const { return State_->IsCancelled.load(); }
+
+		/// <summary>
+		/// Waits for the workers to stop, rethrowing the first exception any of them threw.
+		/// </summary>
+		/// <returns>The image, with only the rows rendered before cancelling filled in if cancelled.</returns>
+		const Canvas& Wait() const
+		{
+			std::unique_lock lock(State_->Mutex);
+			State_->Finished.wait(lock, [&] { return State_->ActiveWorkers == 0; });
+			if (State_->Exception) { std::rethrow_exception(State_->Exception); }
+
+			return State_->Image;
+		}
+
+		/// <returns>Whether the workers stopped within the timeout.</returns>
+		template <typename Rep, typename Period>
+		bool WaitFor(const std::chrono::duration<Rep, Period>& timeout) const
+		{
+			std::unique_lock lock(State_->Mutex);
+			return State_->Finished.wait_for(lock, timeout, [&] { return State_->ActiveWorkers == 0; });
+		}
+
+	private:
+		void Stop()
+		{
+			if (!State_) { return; }
+
+			Cancel();
+			std::unique_lock lock(State_->Mutex);
+			State_->Finished.wait(lock, [&] { return State_->ActiveWorkers == 0; });
+		}
+
+		static void Work(State& state)
+		{
+			for (size_t i = state.NextTile++; i < state.Tiles.size() && !state.IsCancelled; i = state.NextTile++)
+			{
+				const Region& tile = state.Tiles[i];
+				try
+				{
+					TraceScope trace("Tile", tile.X, tile.Y, tile.Width, tile.Height);
+					for (int y = tile.Y; y < tile.Bottom(); ++y)
+					{
+						if (state.IsCancelled) { break; }
+
+						state.Render({tile.X, y, tile.Width, 1}, state.Image);
+					}
+
+					if (state.IsCancelled) { break; }
+
+					++state.TilesDone;
+
+					std::vector<TileCallback> callbacks;
+					{
+						std::lock_guard lock(state.Mutex);
+						callbacks = state.Callbacks;
+					}
+					for (const TileCallback& callback : callbacks) { callback(tile); }
+				}
+				catch (...)
+				{
+					std::lock_guard lock(state.Mutex);
+					if (!state.Exception) { state.Exception = std::current_exception(); }
+					state.IsCancelled = true;
+				}
+			}
+
+			std::lock_guard lock(state.Mutex);
+			if (--state.ActiveWorkers == 0) { state.Finished.notify_all(); }
+		}
+	};
+}
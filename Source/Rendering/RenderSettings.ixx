@@ -0,0 +1,69 @@
+module;
+#include <bit>
+#include <cstdint>
+
+export module RayTracer:RenderSettings;
+
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// How far reflections are followed in a render. Each reflected ray carries its throughput, the fraction of its
+	/// colour that reaches the pixel, being the product of the reflectiveness of every surface it's bounced off.
+	/// </summary>
+	export struct RenderSettings
+	{
+		// Most times a ray is reflected. Past this, reflections are black.
+		int MaxDepth = 4;
+
+		// Reflections whose throughput falls below this aren't traced, as they'd barely change the pixel. 0 traces
+		// every reflection up to MaxDepth.
+		float MinThroughput = 0;
+
+		// Rather than always cutting off reflections below MinThroughput, traces them at random with a chance
+		// proportional to their throughput, weighting the ones traced up to make up for those that weren't. The
+		// image is the same on average, with noise in place of the darkening a hard cut off gives.
+		bool RussianRoulette = false;
+
+		/// <summary>
+		/// Decides whether to trace a reflection, updating its throughput if it's weighted up by Russian roulette.
+		/// The random choice is a hash of where the reflection starts, so renders are repeatable and the same on
+		/// every thread and machine.
+		/// </summary>
+		/// <param name="depth">How many times the ray has already been reflected.</param>
+		/// <returns>What to multiply the reflection's colour by, 0 if it shouldn't be traced.</returns>
+		float ReflectionWeight(float& throughput, const Tuple& origin, int depth) const
+		{
+			if (depth >= MaxDepth || throughput == 0) { return 0; }
+			if (throughput >= MinThroughput) { return 1; }
+			if (!RussianRoulette) { return 0; }
+
+			float survival = throughput / MinThroughput;
+			if (RandomAt(origin, depth) >= survival) { return 0; }
+
+			throughput = MinThroughput;
+			return 1 / survival;
+		}
+
+		bool operator==(const RenderSettings&) const = default;
+
+	private:
+		/// <returns>From 0 up to but not including 1, random looking but the same for the same inputs.</returns>
+		static float RandomAt(const Tuple& point, int depth)
+		{
+			uint32_t hash = static_cast<uint32_t>(depth) * 0x9e3779b9u;
+			for (float value : {point.X, point.Y, point.Z})
+			{
+				hash ^= std::bit_cast<uint32_t>(value);
+				hash *= 0x85ebca6bu;
+				hash ^= hash >> 13;
+				hash *= 0xc2b2ae35u;
+				hash ^= hash >> 16;
+			}
+
+			// The top 24 bits, as many as a float holds exactly.
+			return static_cast<float>(hash >> 8) / static_cast<float>(1u << 24);
+		}
+	};
+}
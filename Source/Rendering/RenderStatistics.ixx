@@ -0,0 +1,92 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+export module RayTracer:RenderStatistics;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// What a heatmap render shows of each pixel's cost.
+	/// </summary>
+	export enum class HeatmapMetric
+	{
+		// Time taken to render the pixel.
+		Nanoseconds,
+
+		IntersectionTests,
+
+		// Rays traced for the pixel, including its primary ray.
+		Rays,
+
+		// Most times the pixel's ray was reflected.
+		Depth
+	};
+
+	/// <summary>
+	/// Counts of the work done by the calling thread, kept by the same code every render runs rather than a
+	/// separate diagnostic path, so that they show what rendering really costs. Being per thread they need no
+	/// synchronisation, and a pixel's work is counted by resetting before it and reading after.\n
+	/// Only counted while a CollectionScope exists, as for a heatmap render. Other renders pay a single relaxed load
+	/// to find that out, rather than updating the counts for every ray.
+	/// </summary>
+	export struct RenderStatistics
+	{
+		// Rays traced into the world, being primary, shadow and reflection rays.
+		uint64_t Rays = 0;
+
+		// Rays tested against individual shapes.
+		uint64_t IntersectionTests = 0;
+
+		// Most times a ray was reflected.
+		int MaxDepth = 0;
+
+		/// <summary>
+		/// Turns counting on, on every thread, for as long as it exists. Scopes can overlap, such as for heatmap
+		/// renders running at the same time, with counting staying on until the last has gone.
+		/// </summary>
+		class CollectionScope
+		{
+		public:
+			CollectionScope() { GetCollectors().fetch_add(1, std::memory_order_relaxed); }
+
+			CollectionScope(const CollectionScope&) = delete;
+
+			CollectionScope& operator=(const CollectionScope&) = delete;
+
+			~CollectionScope() { GetCollectors().fetch_sub(1, std::memory_order_relaxed); }
+		};
+
+		static bool IsCollecting() { return GetCollectors().load(std::memory_order_relaxed) != 0; }
+
+		static RenderStatistics& ThisThread()
+		{
+			thread_local RenderStatistics statistics;
+			return statistics;
+		}
+
+		void Reset() { *this = {}; }
+
+		void RecordDepth(int depth) { MaxDepth = std::max(MaxDepth, depth); }
+
+		/// <returns>The count the metric shows, or 0 for time, which isn't counted here.</returns>
+		float Get(HeatmapMetric metric) const
+		{
+			switch (metric)
+			{
+			case HeatmapMetric::IntersectionTests: return static_cast<float>(IntersectionTests);
+			case HeatmapMetric::Rays: return static_cast<float>(Rays);
+			case HeatmapMetric::Depth: return static_cast<float>(MaxDepth);
+			default: return 0;
+			}
+		}
+
+	private:
+		static std::atomic<int>& GetCollectors()
+		{
+			static std::atomic<int> collectors = 0;
+			return collectors;
+		}
+	};
+}
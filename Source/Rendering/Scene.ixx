@@ -0,0 +1,215 @@
+module;
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+export module RayTracer:Scene;
+
+import :Camera;
+import :Material;
+import :Matrix;
+import :Pattern;
+import :Plane;
+import :RenderSettings;
+import :PointLight;
+import :Shape;
+import :Sphere;
+import :Trace;
+import :Tuple;
+import :World;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A world along with the camera viewing it, everything needed to render an image. Can be written to and read
+	/// from a plain text format so that it can be sent to other processes.
+	/// </summary>
+	export struct Scene
+	{
+		World World_;
+
+		Camera Camera_;
+
+		/// <summary>
+		/// Writes the scene one item per line, a camera line and the camera's render settings followed by an optional
+		/// light line and a line for each object. Floats are written with enough digits to be read back exactly.
+		/// </summary>
+		void Write(std::ostream& stream) const
+		{
+			stream << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+			// The derived sizes are written too, as tanf can round differently on the machine reading the scene.
+			stream << "camera " << Camera_.RenderWidth << ' ' << Camera_.RenderHeight << ' '
+				<< Camera_.FieldOfView << ' ' << Camera_.HalfWidth << ' ' << Camera_.HalfHeight << ' '
+				<< Camera_.PixelSize << ' ';
+			WriteMatrix(stream, Camera_.Transform);
+			stream << '\n';
+
+			const RenderSettings& settings = Camera_.Settings;
+			stream << "settings " << settings.MaxDepth << ' ' << settings.MinThroughput << ' '
+				<< settings.RussianRoulette << '\n';
+
+			if (World_.Light)
+			{
+				stream << "light ";
+				WriteTuple(stream, World_.Light->Position);
+				WriteTuple(stream, World_.Light->Intensity);
+				stream << '\n';
+			}
+
+			for (const Shape* object : World_.Objects)
+			{
+				if (dynamic_cast<const Sphere*>(object)) { stream << "sphere "; }
+				else if (dynamic_cast<const Plane*>(object)) { stream << "plane "; }
+				else { throw std::runtime_error("Scene can't write an unknown shape type."); }
+
+				WriteMatrix(stream, object->GetTransform());
+				WriteMaterial(stream, World_.GetMaterial(*object));
+				stream << '\n';
+			}
+		}
+
+		/// <summary>
+		/// Reads a scene written by Write. Objects and patterns are made together in the world's storage, so they sit
+		/// next to each other in memory and are freed at once along with the world.
+		/// </summary>
+		static Scene Read(std::istream& stream)
+		{
+			TraceScope trace("Read scene");
+			Scene scene{{}, {1, 1, 0}};
+
+			std::string type;
+			while (stream >> type)
+			{
+				if (type == "camera")
+				{
+					int width, height;
+					float fieldOfView, halfWidth, halfHeight, pixelSize;
+					stream >> width >> height >> fieldOfView >> halfWidth >> halfHeight >> pixelSize;
+					scene.Camera_ = Camera(width, height, fieldOfView, ReadMatrix(stream));
+					scene.Camera_.HalfWidth = halfWidth;
+					scene.Camera_.HalfHeight = halfHeight;
+					scene.Camera_.PixelSize = pixelSize;
+				}
+				else if (type == "settings")
+				{
+					RenderSettings& settings = scene.Camera_.Settings;
+					stream >> settings.MaxDepth >> settings.MinThroughput >> settings.RussianRoulette;
+				}
+				else if (type == "light")
+				{
+					Tuple position = ReadTuple(stream);
+					Tuple intensity = ReadTuple(stream);
+					scene.World_.Light = PointLight{position, intensity};
+				}
+				else if (type == "sphere" || type == "plane")
+				{
+					Shape& object = type == "sphere"
+						? static_cast<Shape&>(scene.World_.Add<Sphere>()) : scene.World_.Add<Plane>();
+					object.SetTransform(ReadMatrix(stream));
+					scene.World_.SetMaterial(object, ReadMaterial(stream, scene.World_));
+				}
+				else { throw std::runtime_error("Scene can't read unknown item: " + type); }
+
+				if (!stream) { throw std::runtime_error("Scene is malformed after item: " + type); }
+			}
+
+			return scene;
+		}
+
+	private:
+		static void WriteTuple(std::ostream& stream, const Tuple& tuple)
+		{
+			stream << tuple.X << ' ' << tuple.Y << ' ' << tuple.Z << ' ' << tuple.W << ' ';
+		}
+
+		static Tuple ReadTuple(std::istream& stream)
+		{
+			Tuple tuple{};
+			stream >> tuple.X >> tuple.Y >> tuple.Z >> tuple.W;
+			return tuple;
+		}
+
+		static void WriteMatrix(std::ostream& stream, const Matrix<4>& matrix)
+		{
+			for (float value : matrix.Values) { stream << value << ' '; }
+		}
+
+		static Matrix<4> ReadMatrix(std::istream& stream)
+		{
+			Matrix<4> matrix{};
+			for (float& value : matrix.Values) { stream >> value; }
+			return matrix;
+		}
+
+		static void WriteMaterial(std::ostream& stream, const Material& material)
+		{
+			WriteTuple(stream, material.Colour);
+			stream << material.Ambient << ' ' << material.Diffuse << ' ' << material.Specular << ' '
+				<< material.Shininess << ' ' << material.Reflectiveness << ' ';
+
+			const Pattern* pattern = material.Pattern_;
+			if (!pattern)
+			{
+				stream << "none";
+				return;
+			}
+
+			// Every pattern is currently two colours, so only the name differs.
+			auto writePattern = [&](const char* name, const Tuple& colourA, const Tuple& colourB)
+			{
+				stream << name << ' ';
+				WriteTuple(stream, colourA);
+				WriteTuple(stream, colourB);
+				WriteMatrix(stream, pattern->GetTransform());
+			};
+
+			if (auto stripe = dynamic_cast<const StripePattern*>(pattern))
+			{
+				writePattern("stripe", stripe->ColourA, stripe->ColourB);
+			}
+			else if (auto gradient = dynamic_cast<const GradientPattern*>(pattern))
+			{
+				writePattern("gradient", gradient->ColourA, gradient->ColourB);
+			}
+			else if (auto ring = dynamic_cast<const RingPattern*>(pattern))
+			{
+				writePattern("ring", ring->ColourA, ring->ColourB);
+			}
+			else if (auto checker = dynamic_cast<const CheckerPattern*>(pattern))
+			{
+				writePattern("checker", checker->ColourA, checker->ColourB);
+			}
+			else { throw std::runtime_error("Scene can't write an unknown pattern type."); }
+		}
+
+		/// <param name="world">Where any pattern is made.</param>
+		static Material ReadMaterial(std::istream& stream, World& world)
+		{
+			Material material;
+			material.Colour = ReadTuple(stream);
+			stream >> material.Ambient >> material.Diffuse >> material.Specular >> material.Shininess
+				>> material.Reflectiveness;
+
+			std::string patternType;
+			stream >> patternType;
+			if (patternType == "none") { return material; }
+
+			Tuple colourA = ReadTuple(stream);
+			Tuple colourB = ReadTuple(stream);
+			Pattern* pattern;
+			if (patternType == "stripe") { pattern = world.Make<StripePattern>(colourA, colourB); }
+			else if (patternType == "gradient") { pattern = world.Make<GradientPattern>(colourA, colourB); }
+			else if (patternType == "ring") { pattern = world.Make<RingPattern>(colourA, colourB); }
+			else if (patternType == "checker") { pattern = world.Make<CheckerPattern>(colourA, colourB); }
+			else { throw std::runtime_error("Scene can't read unknown pattern: " + patternType); }
+
+			pattern->SetTransform(ReadMatrix(stream));
+			material.Pattern_ = pattern;
+			return material;
+		}
+	};
+}
@@ -0,0 +1,106 @@
+module;
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+export module RayTracer:Shading;
+
+import :Material;
+import :PointLight;
+import :Shape;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Lights a point on a shape, giving the same result as Material::Lighting but written for one particular
+	/// configuration of material.
+	/// </summary>
+	export using ShadingKernel = Tuple (*)(const Material& material, const Shape& object, const PointLight& light,
+	                                       const Shape::Computation& computation, bool inShadow);
+
+	/// <returns>base raised to exponent, by repeated squaring rather than through logarithms like powf.</returns>
+	export constexpr float IntegerPower(float base, unsigned exponent)
+	{
+		float result = 1;
+		while (exponent > 0)
+		{
+			if (exponent & 1) { result *= base; }
+			base *= base;
+			exponent >>= 1;
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Phong lighting as in Material::Lighting, with whatever the material doesn't use compiled out. Lit or not is
+	/// decided by multiplying rather than branching, as it varies from pixel to pixel where the material doesn't.
+	/// </summary>
+	template <bool HasPattern, bool HasDiffuse, bool HasSpecular, bool IsShininessInteger>
+	Tuple Shade(const Material& material, const Shape& object, const PointLight& light,
+	            const Shape::Computation& computation, bool inShadow)
+	{
+		Tuple materialColour = material.Colour;
+		if constexpr (HasPattern) { materialColour = object.StripeAt(*material.Pattern_, computation.Hit); }
+
+		Tuple effectiveColourOfSurface = Tuple::HadamardProduct(materialColour, light.Intensity);
+		Tuple colour = effectiveColourOfSurface * material.Ambient;
+		if constexpr (!HasDiffuse && !HasSpecular) { return colour; }
+
+		Tuple lightDirection = (light.Position - computation.Hit).Normalised();
+		float lightDotNormal = Tuple::Dot(lightDirection, computation.Normal);
+		float lit = (!inShadow && lightDotNormal >= 0) ? 1.0f : 0.0f;
+
+		if constexpr (HasDiffuse)
+		{
+			colour = colour + effectiveColourOfSurface * (material.Diffuse * lightDotNormal * lit);
+		}
+
+		if constexpr (HasSpecular)
+		{
+			// Light reflecting away from the eye gives nothing. Clamped too so powf isn't given a negative base.
+			Tuple reflectVector = (-lightDirection).Reflect(computation.Normal);
+			float reflectDotEye = Tuple::Dot(reflectVector, computation.EyeVector);
+			float facing = reflectDotEye > 0 ? 1.0f : 0.0f;
+			reflectDotEye = std::max(reflectDotEye, 0.0f);
+
+			float factor;
+			if constexpr (IsShininessInteger)
+			{
+				factor = IntegerPower(reflectDotEye, static_cast<unsigned>(material.Shininess));
+			}
+			else { factor = std::pow(reflectDotEye, material.Shininess); }
+
+			colour = colour + light.Intensity * (material.Specular * factor * lit * facing);
+		}
+
+		return colour;
+	}
+
+	template <size_t... Configurations>
+	constexpr std::array<ShadingKernel, sizeof...(Configurations)> MakeShadingKernels(
+		std::index_sequence<Configurations...>)
+	{
+		return {&Shade<(Configurations & 8) != 0, (Configurations & 4) != 0, (Configurations & 2) != 0,
+		               (Configurations & 1) != 0>...};
+	}
+
+	// Indexed by the configuration's flags as bits, in the order of Shade's template parameters.
+	constexpr std::array<ShadingKernel, 16> ShadingKernels = MakeShadingKernels(std::make_index_sequence<16>{});
+
+	/// <returns>The kernel that does only the work the material needs, chosen once rather than per hit.</returns>
+	export ShadingKernel SelectShadingKernel(const Material& material)
+	{
+		bool hasPattern = material.Pattern_ != nullptr;
+		bool hasDiffuse = material.Diffuse != 0;
+		bool hasSpecular = material.Specular != 0;
+
+		// Bounded so that converting it to unsigned can't overflow.
+		bool isShininessInteger = material.Shininess >= 0 && material.Shininess <= 4096 &&
+			material.Shininess == std::floor(material.Shininess);
+
+		return ShadingKernels[hasPattern << 3 | hasDiffuse << 2 | hasSpecular << 1 | isShininessInteger];
+	}
+}
@@ -0,0 +1,302 @@
+module;
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+export module RayTracer:Wavefront;
+
+import :Bounds;
+import :Canvas;
+import :Material;
+import :Memory;
+import :Morton;
+import :Shading;
+import :Ray;
+import :RenderSettings;
+import :Shape;
+import :Tuple;
+import :World;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Breadth-first alternative to World::ColourAt. Rather than following one pixel through intersection,
+	/// shading, and reflection before moving onto the next, every ray in a queue goes through one stage
+	/// before any ray goes through the next. Each stage is a tight loop over its batch, so the same code and
+	/// data stay hot in the cache for the whole batch.\n
+	/// Shading is deferred until every hit in the wave is known, then done a material at a time, so that each
+	/// material, its pattern and its shading kernel are fetched once per wave rather than once per hit. Shadow and
+	/// reflection rays are traced in an order that keeps similar rays together, see SortCoherently.
+	/// </summary>
+	export class Wavefront
+	{
+	public:
+		/// <summary>
+		/// A ray waiting to be traced, along with where its contribution ends up.
+		/// </summary>
+		struct PathRay
+		{
+			Ray Ray_;
+
+			int X;
+
+			int Y;
+
+			// How much of the ray's colour reaches the pixel, the product of the reflectiveness of every
+			// surface bounced off so far.
+			float Throughput = 1.0f;
+
+			// How many times the ray has been reflected.
+			int Depth = 0;
+		};
+
+		/// <summary>
+		/// The state of a surface hit between the shading stages.
+		/// </summary>
+		struct ShadingPoint
+		{
+			Shape::Computation Computation;
+
+			const PathRay* Path;
+
+			bool InShadow = false;
+		};
+
+		/// <summary>
+		/// A ray from a surface towards the light, which only needs to know whether anything is in the way.
+		/// </summary>
+		struct ShadowRay
+		{
+			Ray Ray_;
+
+			float LightDistance;
+		};
+
+	private:
+		const World& World_;
+
+		RenderSettings Settings_;
+
+	public:
+		/// <summary>
+		/// Prepares the world, which mustn't change while the wavefront is in use.
+		/// </summary>
+		Wavefront(const World& world, const RenderSettings& settings = {}) : World_(world), Settings_(settings)
+		{
+			World_.Prepare();
+		}
+
+		/// <summary>
+		/// Traces the queued rays, and the reflection rays they spawn, to completion, adding each ray's
+		/// contribution to its pixel in the image.
+		/// </summary>
+		void Trace(std::vector<PathRay> queue, Canvas& image) const
+		{
+			std::vector<std::optional<Shape::Intersection>> hits;
+			std::vector<ShadingPoint> shadingPoints;
+			std::vector<ShadingPoint> sortedShadingPoints;
+			std::vector<size_t> materialStarts;
+			std::vector<ShadowRay> shadowRays;
+			std::vector<PathRay> reflections;
+			std::vector<PathRay> sortedReflections;
+			std::vector<std::pair<uint64_t, uint32_t>> order;
+			TrackedBytes memory(MemoryCategory::RayBuffers);
+
+			while (!queue.empty())
+			{
+				IntersectStage(queue, hits);
+				PrepareStage(queue, hits, shadingPoints, shadowRays);
+				ShadowStage(shadowRays, shadingPoints, order);
+				SortStage(shadingPoints, sortedShadingPoints, materialStarts);
+				SurfaceStage(sortedShadingPoints, materialStarts, image, reflections);
+
+				// Reflections are spawned in pixel order, but bounce off in all directions.
+				auto reflectionAt = [&](size_t i) -> const Ray& { return reflections[i].Ray_; };
+				SortCoherently(reflections.size(), reflectionAt, order);
+				sortedReflections.clear();
+				for (auto [key, i] : order) { sortedReflections.push_back(reflections[i]); }
+
+				// Only measured once a wave as the buffers only grow, being reused from wave to wave.
+				memory.Set(BytesOf(queue) + BytesOf(hits) + BytesOf(shadingPoints) + BytesOf(sortedShadingPoints) +
+					BytesOf(materialStarts) + BytesOf(shadowRays) + BytesOf(reflections) + BytesOf(sortedReflections) +
+					BytesOf(order));
+
+				// The reflections become the next wave, the old queue's storage is reused for the wave after.
+				std::swap(queue, sortedReflections);
+				reflections.clear();
+			}
+
+			// Reports the shadow rays' intersections, counted on this thread as they were traced.
+			MemoryTracker::FlushThisThread();
+		}
+
+	private:
+		template <typename T>
+		static size_t BytesOf(const std::vector<T>& buffer) { return buffer.capacity() * sizeof(T); }
+
+		/// <summary>
+		/// Finds the closest hit, if any, of every ray in the queue.
+		/// </summary>
+		void IntersectStage(const std::vector<PathRay>& queue,
+		                    std::vector<std::optional<Shape::Intersection>>& hits) const
+		{
+			hits.resize(queue.size());
+			for (size_t i = 0; i < queue.size(); ++i)
+			{
+				hits[i] = Shape::Intersection::Hit(World_.Intersect(queue[i].Ray_));
+			}
+		}
+
+		/// <summary>
+		/// Turns every hit into a shading point and queues the shadow ray it needs. Misses contribute black, so
+		/// they are dropped here.
+		/// </summary>
+		void PrepareStage(const std::vector<PathRay>& queue,
+		                  const std::vector<std::optional<Shape::Intersection>>& hits,
+		                  std::vector<ShadingPoint>& shadingPoints, std::vector<ShadowRay>& shadowRays) const
+		{
+			shadingPoints.clear();
+			shadowRays.clear();
+
+			for (size_t i = 0; i < queue.size(); ++i)
+			{
+				if (!hits[i]) { continue; }
+
+				const ShadingPoint& shadingPoint = shadingPoints.emplace_back
+				(
+					hits[i]->PrepareComputations(queue[i].Ray_),
+					&queue[i]
+				);
+
+				Tuple lightDirectionNonNormalised = World_.Light->Position - shadingPoint.Computation.HitOffset;
+				shadowRays.push_back
+				({
+					{shadingPoint.Computation.HitOffset, lightDirectionNonNormalised.Normalised()},
+					lightDirectionNonNormalised.Magnitude()
+				});
+			}
+		}
+
+		/// <summary>
+		/// Tests every shadow ray for occlusion, with shadow rays matching shading points one to one.
+		/// </summary>
+		void ShadowStage(const std::vector<ShadowRay>& shadowRays, std::vector<ShadingPoint>& shadingPoints,
+		                 std::vector<std::pair<uint64_t, uint32_t>>& order) const
+		{
+			SortCoherently(shadowRays.size(), [&](size_t i) -> const Ray& { return shadowRays[i].Ray_; }, order);
+			for (auto [key, i] : order)
+			{
+				shadingPoints[i].InShadow = World_.IsOccluded(shadowRays[i].Ray_, shadowRays[i].LightDistance);
+			}
+		}
+
+		/// <summary>
+		/// Orders rays by the octant their direction points into, then by where they start along a Morton curve
+		/// through the box around all of their origins. Rays next to each other in that order start close together
+		/// and head the same general way, so they tend to visit the same boxes of the acceleration structure and the
+		/// same objects while those are still in the cache.
+		/// </summary>
+		/// <param name="order">Filled with each ray's sort key and index, in the order to trace them.</param>
+		template <typename RayAt>
+		static void SortCoherently(size_t count, RayAt rayAt, std::vector<std::pair<uint64_t, uint32_t>>& order)
+		{
+			Bounds origins = Bounds::Empty();
+			for (size_t i = 0; i < count; ++i) { origins.Extend(rayAt(i).Origin); }
+
+			// Origins are placed on a 1024 cell grid along each axis, the most a 3D Morton code of 32 bits holds.
+			constexpr uint32_t Cells = 1024;
+			Tuple extent = origins.Max - origins.Min;
+
+			order.resize(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const Ray& ray = rayAt(i);
+
+				uint32_t cell[3];
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					float offset = extent[axis] > 0 ? (ray.Origin[axis] - origins.Min[axis]) / extent[axis] : 0;
+					cell[axis] = std::min(static_cast<uint32_t>(offset * Cells), Cells - 1);
+				}
+
+				uint64_t octant = (ray.Direction.X < 0) | (ray.Direction.Y < 0) << 1 | (ray.Direction.Z < 0) << 2;
+				order[i] = {octant << 32 | MortonCode(cell[0], cell[1], cell[2]), static_cast<uint32_t>(i)};
+			}
+
+			std::sort(order.begin(), order.end());
+		}
+
+		/// <summary>
+		/// Groups the shading points by material with a counting sort, which keeps points with the same material in
+		/// the order they were in. materialStarts gets where each material's points start, followed by the total.
+		/// </summary>
+		void SortStage(const std::vector<ShadingPoint>& shadingPoints, std::vector<ShadingPoint>& sorted,
+		               std::vector<size_t>& materialStarts) const
+		{
+			// Read from each point's object once, rather than again while placing it.
+			std::vector<uint32_t> materialIndices;
+			materialIndices.reserve(shadingPoints.size());
+			materialStarts.assign(World_.Materials.GetSize() + 1, 0);
+			for (const ShadingPoint& shadingPoint : shadingPoints)
+			{
+				materialIndices.push_back(shadingPoint.Computation.Object->GetMaterialIndex());
+				assert(materialIndices.back() < World_.Materials.GetSize());
+				++materialStarts[materialIndices.back() + 1];
+			}
+			for (size_t i = 1; i < materialStarts.size(); ++i) { materialStarts[i] += materialStarts[i - 1]; }
+
+			// Counts from each material's start, leaving materialStarts as it is.
+			std::vector<size_t> next(materialStarts.begin(), materialStarts.end() - 1);
+
+			// Sized by copying, as shading points can't be default constructed, then overwritten in order.
+			sorted = shadingPoints;
+			for (size_t i = 0; i < shadingPoints.size(); ++i)
+			{
+				sorted[next[materialIndices[i]]++] = shadingPoints[i];
+			}
+		}
+
+		/// <summary>
+		/// Lights every shading point a material at a time, adds the result to its pixel, and queues reflection rays
+		/// for reflective surfaces that still have depth left.
+		/// </summary>
+		void SurfaceStage(const std::vector<ShadingPoint>& shadingPoints, const std::vector<size_t>& materialStarts,
+		                  Canvas& image, std::vector<PathRay>& reflections) const
+		{
+			for (uint32_t materialIndex = 0; materialIndex + 1 < materialStarts.size(); ++materialIndex)
+			{
+				const Material& material = World_.Materials[materialIndex];
+				ShadingKernel kernel = World_.Materials.GetKernel(materialIndex);
+
+				for (size_t i = materialStarts[materialIndex]; i < materialStarts[materialIndex + 1]; ++i)
+				{
+					const Shape::Computation& computation = shadingPoints[i].Computation;
+					const PathRay& path = *shadingPoints[i].Path;
+
+					Tuple surface = kernel(material, *computation.Object, *World_.Light, computation,
+					                       shadingPoints[i].InShadow);
+					image.SetPixel(path.X, path.Y, image.GetPixel(path.X, path.Y) + surface * path.Throughput);
+
+					if (material.Reflectiveness == 0) { continue; }
+
+					// Surviving Russian roulette raises the throughput by exactly the weight, so it needs no more
+					// than that.
+					float throughput = path.Throughput * material.Reflectiveness;
+					if (Settings_.ReflectionWeight(throughput, computation.HitOffset, path.Depth) == 0) { continue; }
+
+					reflections.push_back
+					({
+						{computation.HitOffset, computation.Reflection},
+						path.X,
+						path.Y,
+						throughput,
+						path.Depth + 1
+					});
+				}
+			}
+		}
+	};
+}
@@ -1,16 +1,27 @@
 module;
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 export module RayTracer:World;
 
+import :Arena;
+import :BVH;
+import :Material;
+import :MaterialTable;
+import :Memory;
 import :Shape;
 import :Sphere;
+import :Trace;
 import :PointLight;
 import :Ray;
+import :RenderSettings;
+import :RenderStatistics;
 
 namespace RayTracer
 {
@@ -19,29 +30,135 @@ namespace RayTracer
 	public:
 		static World ExampleWorld()
 		{
-			PointLight light{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
+			World world;
+			world.Light = PointLight{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
 
-			std::shared_ptr<Sphere> sphere1 = std::make_shared<Sphere>(Material{Tuple::Colour(0.8, 1.0, 0.6)});
-			sphere1->Material_.Diffuse = 0.7;
-			sphere1->Material_.Specular = 0.2;
-			std::shared_ptr<Sphere> sphere2 = std::make_shared<Sphere>(Matrix<4>::Scaling(0.5, 0.5, 0.5));
+			Sphere& sphere1 = world.Add<Sphere>();
+			world.SetMaterial(sphere1, Material{.Colour = Tuple::Colour(0.8, 1.0, 0.6), .Diffuse = 0.7f,
+			                                    .Specular = 0.2f});
+			world.Add<Sphere>(Matrix<4>::Scaling(0.5, 0.5, 0.5));
 
-			return {{sphere1, sphere2}, light};
+			return world;
 		}
 
-		static constexpr int MaxRecursionDepth = 4;
+		static constexpr int MaxRecursionDepth = RenderSettings{}.MaxDepth;
 
-		std::vector<std::shared_ptr<Shape>> Objects;
+		// Not owned by the world, objects belong to Storage if made by Add, otherwise to whatever made them.
+		std::vector<Shape*> Objects;
 
 		std::optional<PointLight> Light;
 
+		// Where Add and Make put objects and patterns, which all live for as long as the world. Copies of the world
+		// share it along with the objects, rather than every object being reference counted.
+		std::shared_ptr<Arena> Storage = std::make_shared<Arena>();
+
+		// Only used once built, and only while the objects are the ones it was built from.
+		BVH Acceleration;
+
+		// The objects' materials without duplicates, which objects refer to by index. Only ever added to, by
+		// SetMaterial, so an index stays valid for as long as the world and any copies of it.
+		MaterialTable Materials;
+
+		// Whether Acceleration was built from the objects as they were when last prepared or built. Checked once
+		// there rather than for every ray, as it means comparing every object.
+		mutable bool IsAccelerationCurrent = false;
+
+		/// <summary>
+		/// Makes an object in the world's storage and adds it to the world.
+		/// </summary>
+		template <typename T, typename... Args>
+		T& Add(Args&&... args)
+		{
+			T* object = Make<T>(std::forward<Args>(args)...);
+			Objects.push_back(object);
+
+			return *object;
+		}
+
+		/// <summary>
+		/// Makes something that lives as long as the world in its storage, such as a pattern for an object's material.
+		/// </summary>
+		template <typename T, typename... Args>
+		T* Make(Args&&... args) { return Storage->Make<T>(std::forward<Args>(args)...); }
+
+		/// <summary>
+		/// Gives the object the material, sharing the table's entry for it if another object already has one the
+		/// same. The object's index is into this world's table, so an object in several worlds should only be given
+		/// its material by one of them, or by a world they were all copied from.
+		/// </summary>
+		void SetMaterial(Shape& object, const Material& material) { object.SetMaterialIndex(Materials.Add(material)); }
+
+		const Material& GetMaterial(const Shape& object) const { return Materials[object.GetMaterialIndex()]; }
+
+		/// <summary>
+		/// Builds the acceleration structure from the objects as they are now. Needs refitting if they move, or
+		/// rebuilding if any are added or removed.
+		/// </summary>
+		void BuildAccelerationStructure()
+		{
+			TraceScope trace("Build acceleration structure");
+			Acceleration.Build(Objects);
+			IsAccelerationCurrent = true;
+		}
+
+		/// <summary>
+		/// Updates the acceleration structure's boxes after objects have moved, keeping its tree.
+		/// </summary>
+		void RefitAccelerationStructure()
+		{
+			if (Acceleration.IsBuiltFor(Objects)) { Acceleration.Refit(); }
+		}
+
+		/// <summary>
+		/// Updates the acceleration structure's boxes after only the given objects have moved, without working out
+		/// the bounds of any of the others again.
+		/// </summary>
+		void RefitAccelerationStructure(std::span<Shape* const> moved)
+		{
+			if (Acceleration.IsBuiltFor(Objects)) { Acceleration.Refit(moved); }
+		}
+
+		/// <summary>
+		/// Checks whether the acceleration structure still matches the objects, so that rendering from several threads
+		/// afterwards only ever reads the world. Needs calling again after adding or removing objects. Nothing is
+		/// written if nothing has changed since it was last prepared, so preparing a world that's already rendering
+		/// is safe.
+		/// </summary>
+		void Prepare() const
+		{
+			TraceScope trace("Prepare world");
+
+			bool isAccelerationCurrent = Acceleration.IsBuiltFor(Objects);
+			if (isAccelerationCurrent != IsAccelerationCurrent) { IsAccelerationCurrent = isAccelerationCurrent; }
+		}
+
+		/// <summary>
+		/// Every intersection of the ray with the world's objects, sorted. When the acceleration structure is
+		/// built, objects entirely behind the ray's origin are skipped as they can't be hit.
+		/// </summary>
 		std::vector<Shape::Intersection> Intersect(const Ray& ray) const
 		{
+			RenderStatistics* statistics = RenderStatistics::IsCollecting() ? &RenderStatistics::ThisThread() : nullptr;
+			if (statistics) { ++statistics->Rays; }
+
 			std::vector<Shape::Intersection> intersections;
-			for (const std::shared_ptr<Shape>& object : Objects)
+			auto intersectObject = [&](Shape& object)
 			{
-				std::vector<Shape::Intersection> objectIntersections = object->Intersect(ray);
+				if (statistics) { ++statistics->IntersectionTests; }
+				std::vector<Shape::Intersection> objectIntersections = object.Intersect(ray);
 				intersections.insert(intersections.end(), objectIntersections.begin(), objectIntersections.end());
+			};
+
+			// Objects added or removed since then are caught here too. One swapped for another isn't until the world is
+			// prepared again, but objects live as long as the storage they were made in, so the tree is never left
+			// pointing at a freed one.
+			if (IsAccelerationCurrent && Acceleration.GetObjectCount() == Objects.size())
+			{
+				Acceleration.ForEachCandidate(ray, intersectObject);
+			}
+			else
+			{
+				for (Shape* object : Objects) { intersectObject(*object); }
 			}
 
 			auto sortAscendingWithNegativesAtEnd = [](const Shape::Intersection& lhs, const Shape::Intersection& rhs)
@@ -53,17 +170,40 @@ namespace RayTracer
 			return intersections;
 		}
 
+		/// <returns>
+		/// The lit colour of the surface at the computation, not including reflections, using the shading kernel
+		/// chosen for the object's material.
+		/// </returns>
+		Tuple SurfaceColour(const Shape::Computation& computation, bool inShadow) const
+		{
+			uint32_t index = computation.Object->GetMaterialIndex();
+			return Materials.GetKernel(index)(Materials[index], *computation.Object, *Light, computation, inShadow);
+		}
+
 		Tuple ShadeIntersection(const Shape::Computation& computation, int maxDepth = MaxRecursionDepth) const
+		{
+			return ShadeIntersection(computation, RenderSettings{maxDepth});
+		}
+
+		/// <param name="depth">How many times the ray that hit has already been reflected.</param>
+		/// <param name="throughput">How much of the ray's colour reaches the pixel.</param>
+		Tuple ShadeIntersection(const Shape::Computation& computation, const RenderSettings& settings, int depth = 0,
+		                        float throughput = 1) const
 		{
 			bool isShadowed = IsPointInShadow(computation.HitOffset);
 
-			// To support multiple lights iterate over all sources and add together resulting values.
-			// But how does that handle values > 1? Do they just get clipped at some point?
-			Tuple surface = computation.Object->Lighting(*Light, computation.Hit, computation.EyeVector,
-			                                             computation.Normal,
-			                                             isShadowed);
+			// Looked up once for the whole hit, shading and reflecting alike.
+			uint32_t index = computation.Object->GetMaterialIndex();
+			const Material& material = Materials[index];
+
+			// To support multiple lights iterate over all sources and add together resulting values. Values above 1
+			// are kept, to be clipped when written or brought into range by PostProcess.
+			Tuple surface = Materials.GetKernel(index)(material, *computation.Object, *Light, computation, isShadowed);
 
-			Tuple reflected = ReflectedColour(computation, maxDepth);
+			// Checked here rather than left to ReflectedColour, as most surfaces aren't reflective.
+			if (material.Reflectiveness == 0) { return surface; }
+
+			Tuple reflected = ReflectedColour(computation, material, settings, depth, throughput);
 
 			// Blend together the surface and reflection.
 			return surface + reflected;
@@ -71,12 +211,31 @@ namespace RayTracer
 
 		Tuple ColourAt(const Ray& ray, int maxDepth = MaxRecursionDepth) const
 		{
+			return ColourAt(ray, RenderSettings{maxDepth});
+		}
+
+		Tuple ColourAt(const Ray& ray, const RenderSettings& settings, int depth = 0, float throughput = 1) const
+		{
+			if (RenderStatistics::IsCollecting()) { RenderStatistics::ThisThread().RecordDepth(depth); }
+			std::optional<Shape::Computation> computation = ComputationAt(ray);
+
+			if (!computation) { return Colour::Black; }
+
+			return ShadeIntersection(*computation, settings, depth, throughput);
+		}
+
+		/// <returns>Everything needed to shade where the ray first hits the world, if it hits anything.</returns>
+		std::optional<Shape::Computation> ComputationAt(const Ray& ray) const
+		{
+			// Counted by this thread alone, and reported along with the rest of the tile's rays when it's done.
 			std::vector<Shape::Intersection> intersections = Intersect(ray);
+			size_t bytes = intersections.capacity() * sizeof(Shape::Intersection);
+			ThreadTrackedBytes memory(MemoryCategory::RayBuffers, bytes);
 			std::optional<Shape::Intersection> intersection = Shape::Intersection::Hit(intersections);
 
-			if (!intersection) { return Colour::Black; }
+			if (!intersection) { return {}; }
 
-			return ShadeIntersection(intersection->PrepareComputations(ray), maxDepth);
+			return intersection->PrepareComputations(ray);
 		}
 
 		bool IsPointInShadow(Tuple point) const
@@ -87,27 +246,50 @@ namespace RayTracer
 
 			Ray ray{point, lightDirection};
 
+			return IsOccluded(ray, lightDistance);
+		}
+
+		/// <returns>Whether anything along the ray is hit before reaching the given distance.</returns>
+		bool IsOccluded(const Ray& ray, float distance) const
+		{
 			std::vector<Shape::Intersection> intersections = Intersect(ray);
+			size_t bytes = intersections.capacity() * sizeof(Shape::Intersection);
+			ThreadTrackedBytes memory(MemoryCategory::RayBuffers, bytes);
 
 			std::optional<Shape::Intersection> hit = Shape::Intersection::Hit(intersections);
-			if (hit && hit->Time < lightDistance) { return true; }
+			if (hit && hit->Time < distance) { return true; }
 
 			return false;
 		}
 
 		Tuple ReflectedColour(const Shape::Computation& computation, int maxDepth = MaxRecursionDepth) const
 		{
-			// Return early if there's no reflection to be done.
-			if (maxDepth <= 0) { return Colour::Black; }
+			return ReflectedColour(computation, RenderSettings{maxDepth});
+		}
+
+		Tuple ReflectedColour(const Shape::Computation& computation, const RenderSettings& settings, int depth = 0,
+		                      float throughput = 1) const
+		{
+			return ReflectedColour(computation, GetMaterial(*computation.Object), settings, depth, throughput);
+		}
 
+		/// <param name="material">The hit object's material, already looked up by the caller.</param>
+		Tuple ReflectedColour(const Shape::Computation& computation, const Material& material,
+		                      const RenderSettings& settings, int depth = 0, float throughput = 1) const
+		{
 			// Return early if material isn't reflective to save on computation.
-			float materialReflectiveness = computation.Object->Material_.Reflectiveness;
+			float materialReflectiveness = material.Reflectiveness;
 			if (materialReflectiveness == 0) { return Colour::Black; }
 
+			// Return early if there's no reflection to be done, or it would contribute too little to be worth it.
+			float reflectedThroughput = throughput * materialReflectiveness;
+			float weight = settings.ReflectionWeight(reflectedThroughput, computation.HitOffset, depth);
+			if (weight == 0) { return Colour::Black; }
+
 			Ray reflectionRay{computation.HitOffset, computation.Reflection};
-			Tuple colour = ColourAt(reflectionRay, --maxDepth);
+			Tuple colour = ColourAt(reflectionRay, settings, depth + 1, reflectedThroughput);
 
-			return colour * materialReflectiveness;
+			return colour * (materialReflectiveness * weight);
 		}
 	};
 }
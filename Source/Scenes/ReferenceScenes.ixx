@@ -0,0 +1,193 @@
+module;
+#include <numbers>
+#include <string>
+#include <vector>
+
+export module RayTracer.ReferenceScenes;
+
+import RayTracer;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// The scenes from the book's chapters and the examples, built at any size, for the executable to render and for
+	/// render regression tests to compare against their golden images. Kept out of the RayTracer module, in a
+	/// library of their own, as they're content rather than part of the renderer.
+	/// </summary>
+	export namespace ReferenceScenes
+	{
+		/// <summary>
+		/// Chapter 7's spheres in a room, with the floor and walls made of flattened spheres.
+		/// </summary>
+		Scene Spheres(int width = 512, int height = 512)
+		{
+			World world;
+			world.Light = PointLight{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
+
+			Material wall{.Colour = Tuple::Colour(1, 0.9, 0.9), .Specular = 0};
+			Sphere& floor = world.Add<Sphere>();
+			floor.SetTransform(Matrix<4>::Scaling(10, 0.03, 10));
+			world.SetMaterial(floor, wall);
+
+			Sphere& leftWall = world.Add<Sphere>();
+			leftWall.SetTransform(Matrix<4>::Scaling(10, 0.03, 10).RotateX(std::numbers::pi / 2)
+				.RotateY(-std::numbers::pi / 4).Translate(0, 0, 5));
+			world.SetMaterial(leftWall, wall);
+
+			Sphere& rightWall = world.Add<Sphere>();
+			rightWall.SetTransform(Matrix<4>::Scaling(10, 0.03, 10).RotateX(std::numbers::pi / 2)
+				.RotateY(std::numbers::pi / 4).Translate(0, 0, 5));
+			world.SetMaterial(rightWall, wall);
+
+			Sphere& left = world.Add<Sphere>();
+			left.SetTransform(Matrix<4>::Scaling(0.33, 0.33, 0.33).Translate(-1.5, 0.33, -0.75));
+			world.SetMaterial(left, Material{.Colour = Tuple::Colour(1, 0.8, 0.1),
+			                                 .Diffuse = 0.7f, .Specular = 0.3f});
+
+			Sphere& middle = world.Add<Sphere>();
+			middle.SetTransform(Matrix<4>::Translation(-0.5, 1, 0.5));
+			world.SetMaterial(middle, Material{.Colour = Tuple::Colour(0.5, 1, 0.1),
+			                                   .Diffuse = 0.7f, .Specular = 0.3f});
+
+			Sphere& right = world.Add<Sphere>();
+			right.SetTransform(Matrix<4>::Scaling(0.5, 0.5, 0.5).Translate(1.5, 0.5, 0.1));
+			world.SetMaterial(right, Material{.Colour = Tuple::Colour(0.5, 1, 0.1),
+			                                  .Diffuse = 0.7f, .Specular = 0.3f});
+
+			Camera camera(width, height, std::numbers::pi / 3,
+			              Matrix<4>::ViewTransform(Tuple::Point(0, 1.5, -5), Tuple::Point(0, 1, 0),
+			                                       Tuple::Vector(0, 1, 0)));
+
+			return {world, camera};
+		}
+
+		/// <summary>
+		/// Chapter 9's spheres on a plane.
+		/// </summary>
+		Scene Planes(int width = 512, int height = 512)
+		{
+			World world;
+			world.Light = PointLight{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
+
+			Plane& floor = world.Add<Plane>();
+			world.SetMaterial(floor, Material{.Colour = Tuple::Colour(1, 0.9, 0.9), .Specular = 0});
+
+			Sphere& left = world.Add<Sphere>();
+			left.SetTransform(Matrix<4>::Scaling(0.33, 0.33, 0.33).Translate(-1.5, 0.33, -0.75));
+			world.SetMaterial(left, Material{.Colour = Tuple::Colour(1, 0.8, 0.1),
+			                                 .Diffuse = 0.7f, .Specular = 0.3f});
+
+			Sphere& middle = world.Add<Sphere>();
+			middle.SetTransform(Matrix<4>::Translation(-0.5, 1, 0.5));
+			world.SetMaterial(middle, Material{.Colour = Tuple::Colour(0.5, 1, 0.1),
+			                                   .Diffuse = 0.7f, .Specular = 0.3f});
+
+			Sphere& right = world.Add<Sphere>();
+			right.SetTransform(Matrix<4>::Scaling(0.5, 0.5, 0.5).Translate(1.5, 0.5, 0.1));
+			world.SetMaterial(right, Material{.Colour = Tuple::Colour(0.5, 1, 0.1),
+			                                  .Diffuse = 0.7f, .Specular = 0.3f});
+
+			Camera camera(width, height, std::numbers::pi / 3,
+			              Matrix<4>::ViewTransform(Tuple::Point(0, 1.5, -5), Tuple::Point(0, 1, 0),
+			                                       Tuple::Vector(0, 1, 0)));
+
+			return {world, camera};
+		}
+
+		/// <summary>
+		/// Chapter 10's patterned spheres in front of a wall.
+		/// </summary>
+		Scene Patterns(int width = 128, int height = 128)
+		{
+			World world;
+			world.Light = PointLight{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
+
+			Plane& floor = world.Add<Plane>();
+			GradientPattern* gradient = world.Make<GradientPattern>(Colour::Red, Colour::Green);
+			gradient->SetTransform(Matrix<4>::Scaling(10, 10, 10).Translate(5, 0, 0));
+			world.SetMaterial(floor, Material{.Colour = Tuple::Colour(1, 0.9, 0.9), .Specular = 0,
+			                                  .Pattern_ = gradient});
+
+			Plane& backWall = world.Add<Plane>();
+			backWall.SetTransform(Matrix<4>::RotationX(-std::numbers::pi / 2).Translate(0, 0, 3));
+			world.SetMaterial(backWall, Material{.Colour = Tuple::Colour(1, 0.9, 0.9)});
+
+			Sphere& left = world.Add<Sphere>();
+			left.SetTransform(Matrix<4>::Scaling(0.33, 0.33, 0.33).Translate(-1.5, 0.33, -0.75));
+			CheckerPattern* checkers = world.Make<CheckerPattern>(Colour::Blue, Tuple::Colour(0.75, 0.75, 1));
+			world.SetMaterial(left, Material{.Colour = Tuple::Colour(1, 0.8, 0.1), .Diffuse = 0.7f, .Specular = 0.3f,
+			                                 .Pattern_ = checkers});
+
+			Sphere& middle = world.Add<Sphere>();
+			middle.SetTransform(Matrix<4>::Translation(-0.5, 1, 0.5));
+			StripePattern* stripes = world.Make<StripePattern>(Colour::White, Colour::Black);
+			stripes->SetTransform(Matrix<4>::Scaling(0.25, 0.25, 0.25));
+			world.SetMaterial(middle, Material{.Colour = Tuple::Colour(0.5, 1, 0.1), .Diffuse = 0.7f, .Specular = 0.3f,
+			                                   .Pattern_ = stripes});
+
+			Sphere& right = world.Add<Sphere>();
+			right.SetTransform(Matrix<4>::Scaling(0.5, 0.5, 0.5).Translate(1, 1, 1));
+			RingPattern* rings = world.Make<RingPattern>(Colour::Red, Tuple::Colour(1, 0.75, 0.75));
+			rings->SetTransform(Matrix<4>::Scaling(0.25, 0.25, 0.25).RotateX(std::numbers::pi / 2));
+			world.SetMaterial(right, Material{.Colour = Tuple::Colour(0.5, 1, 0.1), .Diffuse = 0.7f, .Specular = 0.3f,
+			                                  .Pattern_ = rings});
+
+			Camera camera(width, height, std::numbers::pi / 3,
+			              Matrix<4>::ViewTransform(Tuple::Point(0, 1.5, -5), Tuple::Point(0, 1, 0),
+			                                       Tuple::Vector(0, 1, 0)));
+
+			return {world, camera};
+		}
+
+		/// <summary>
+		/// A sphere between two facing mirrors, reflecting back and forth as deep as the render settings allow.
+		/// </summary>
+		Scene Mirrors(int width = 128, int height = 128)
+		{
+			World world;
+			world.Light = PointLight{Tuple::Point(0, 0, 0), Colour::White};
+			Shape& lower = world.Add<Plane>();
+			world.SetMaterial(lower, Material{.Reflectiveness = 1});
+			lower.SetTransform(Matrix<4>::Translation(0, -1, 0));
+
+			Shape& upper = world.Add<Plane>();
+			world.SetMaterial(upper, Material{.Reflectiveness = 1});
+			upper.SetTransform(Matrix<4>::RotationX(-std::numbers::pi).Translate(0, 1, 0));
+
+			Shape& sphere = world.Add<Sphere>();
+			sphere.SetTransform(Matrix<4>::Scaling(0.5, 0.5, 0.5).Translate(0, 0, 1));
+
+			Camera camera(width, height, std::numbers::pi / 3,
+			              Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 1),
+			                                       Tuple::Vector(0, 1, 0)));
+
+			return {world, camera};
+		}
+
+		/// <summary>
+		/// World::ExampleWorld, the book's default world, seen from in front.
+		/// </summary>
+		Scene Example(int width = 128, int height = 128)
+		{
+			Camera camera(width, height, std::numbers::pi / 3,
+			              Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+			                                       Tuple::Vector(0, 1, 0)));
+
+			return {World::ExampleWorld(), camera};
+		}
+
+		struct Entry
+		{
+			std::string Name;
+
+			Scene (*Build)(int width, int height);
+		};
+
+		/// <returns>Every reference scene with a name to identify it by, such as in file names.</returns>
+		std::vector<Entry> All()
+		{
+			return {{"Spheres", &Spheres}, {"Planes", &Planes}, {"Patterns", &Patterns}, {"Mirrors", &Mirrors},
+			        {"Example", &Example}};
+		}
+	}
+}
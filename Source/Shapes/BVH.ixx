@@ -0,0 +1,239 @@
+module;
+#include <algorithm>
+#include <span>
+#include <vector>
+
+export module RayTracer:BVH;
+
+import :Bounds;
+import :Memory;
+import :Ray;
+import :Shape;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Bounding volume hierarchy over a world's objects, letting a ray skip every object in a box it misses.\n
+	/// The tree is stored flattened depth first, so a node's left child directly follows it and children always come
+	/// after their parents. When objects move, Refit updates the boxes in place without rebuilding the tree, which is
+	/// much cheaper but gets less efficient the further objects move from where they were when it was built.
+	/// </summary>
+	export class BVH
+	{
+	public:
+		struct Node
+		{
+			Bounds Bounds_;
+
+			// Index of the right child of an interior node, the left child is always the next node.
+			int RightChild = 0;
+
+			int FirstShape = 0;
+
+			// Leaves have shapes, interior nodes don't.
+			int ShapeCount = 0;
+
+			bool IsLeaf() const { return ShapeCount > 0; }
+		};
+
+		static constexpr int MaxLeafSize = 4;
+
+	private:
+		std::vector<Node> Nodes_;
+
+		// The objects built from, for checking whether they're still the world's.
+		std::vector<Shape*> Objects_;
+
+		// Bounded shapes ordered so that each leaf's shapes are next to each other.
+		std::vector<Shape*> Shapes_;
+
+		// The world bounds of each of Shapes_, as they were when last built or refitted.
+		std::vector<Bounds> ShapeBounds_;
+
+		// Shapes like planes which go on forever would make every box they're in infinite, so they're kept to one
+		// side and tested against every ray.
+		std::vector<Shape*> Unbounded_;
+
+		bool IsBuilt_ = false;
+
+		TrackedBytes Memory_{MemoryCategory::Acceleration};
+
+	public:
+		void Build(const std::vector<Shape*>& objects)
+		{
+			Nodes_.clear();
+			Shapes_.clear();
+			ShapeBounds_.clear();
+			Unbounded_.clear();
+
+			// Each shape's bounds are worked out once here rather than every time the split compares them.
+			std::vector<BuildShape> bounded;
+			for (Shape* object : objects)
+			{
+				Bounds bounds = object->WorldBounds();
+				if (bounds.IsFinite()) { bounded.push_back({object, bounds, bounds.Centre()}); }
+				else { Unbounded_.push_back(object); }
+			}
+
+			if (!bounded.empty()) { BuildNode(bounded, 0, static_cast<int>(bounded.size())); }
+			for (const BuildShape& shape : bounded)
+			{
+				Shapes_.push_back(shape.Object);
+				ShapeBounds_.push_back(shape.Bounds_);
+			}
+
+			Objects_ = objects;
+			IsBuilt_ = true;
+			Memory_.Set(Nodes_.capacity() * sizeof(Node) + ShapeBounds_.capacity() * sizeof(Bounds) +
+				(Objects_.capacity() + Shapes_.capacity() + Unbounded_.capacity()) * sizeof(Shape*));
+		}
+
+		/// <summary>
+		/// Recalculates every box from the bounds of its shapes, keeping the tree's structure.
+		/// </summary>
+		void Refit() { RefitWhere([](const Shape*) { return true; }); }
+
+		/// <summary>
+		/// Recalculates every box as Refit does, but only works out the bounds of the shapes that moved again,
+		/// keeping the rest from when the tree was last built or refitted.
+		/// </summary>
+		void Refit(std::span<Shape* const> moved)
+		{
+			std::vector<const Shape*> sorted(moved.begin(), moved.end());
+			std::ranges::sort(sorted);
+			RefitWhere([&](const Shape* shape) { return std::ranges::binary_search(sorted, shape); });
+		}
+
+		/// <returns>
+		/// Whether the hierarchy was built from exactly these objects, in the same order. Compares every object, so
+		/// is meant for checking once before rendering rather than for every ray.
+		/// </returns>
+		bool IsBuiltFor(const std::vector<Shape*>& objects) const
+		{
+			return IsBuilt_ && Objects_ == objects;
+		}
+
+		size_t GetObjectCount() const { return Objects_.size(); }
+
+		const std::vector<Node>& GetNodes() const { return Nodes_; }
+
+		/// <summary>
+		/// Calls visit with every shape the ray could hit, being every shape in a box the ray passes through and
+		/// every unbounded shape. Shapes entirely behind the ray's origin are skipped.
+		/// </summary>
+		template <typename Visitor>
+		void ForEachCandidate(const Ray& ray, Visitor&& visit) const
+		{
+			for (Shape* shape : Unbounded_) { visit(*shape); }
+			if (Nodes_.empty()) { return; }
+
+			// Deep enough for any tree built from a median split, which halves the shapes at every level.
+			int stack[64];
+			int stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while (stackSize > 0)
+			{
+				const Node& node = Nodes_[stack[--stackSize]];
+				if (!node.Bounds_.Intersects(ray)) { continue; }
+
+				if (node.IsLeaf())
+				{
+					for (Shape* shape : LeafShapes(node)) { visit(*shape); }
+					continue;
+				}
+
+				stack[stackSize++] = node.RightChild;
+				stack[stackSize++] = static_cast<int>(&node - Nodes_.data()) + 1;
+			}
+		}
+
+	private:
+		template <typename Predicate>
+		void RefitWhere(Predicate hasMoved)
+		{
+			for (size_t i = 0; i < Shapes_.size(); ++i)
+			{
+				if (hasMoved(Shapes_[i])) { ShapeBounds_[i] = Shapes_[i]->WorldBounds(); }
+			}
+
+			for (int i = static_cast<int>(Nodes_.size()) - 1; i >= 0; --i)
+			{
+				Node& node = Nodes_[i];
+				node.Bounds_ = Bounds::Empty();
+				if (node.IsLeaf())
+				{
+					for (int shape = node.FirstShape; shape < node.FirstShape + node.ShapeCount; ++shape)
+					{
+						node.Bounds_.Extend(ShapeBounds_[shape]);
+					}
+				}
+				else
+				{
+					node.Bounds_.Extend(Nodes_[i + 1].Bounds_);
+					node.Bounds_.Extend(Nodes_[node.RightChild].Bounds_);
+				}
+			}
+		}
+
+		struct BuildShape
+		{
+			Shape* Object;
+
+			Bounds Bounds_;
+
+			Tuple Centre;
+		};
+
+		std::span<Shape* const> LeafShapes(const Node& node) const
+		{
+			return {Shapes_.data() + node.FirstShape, static_cast<size_t>(node.ShapeCount)};
+		}
+
+		/// <summary>
+		/// Builds the subtree for a range of shapes, splitting them in half along the axis their centres are most
+		/// spread out on.
+		/// </summary>
+		void BuildNode(std::vector<BuildShape>& shapes, int first, int count)
+		{
+			int index = static_cast<int>(Nodes_.size());
+			Nodes_.emplace_back();
+
+			Bounds bounds = Bounds::Empty();
+			Bounds centres = Bounds::Empty();
+			for (int i = first; i < first + count; ++i)
+			{
+				bounds.Extend(shapes[i].Bounds_);
+				centres.Extend(shapes[i].Centre);
+			}
+			Nodes_[index].Bounds_ = bounds;
+
+			if (count <= MaxLeafSize)
+			{
+				Nodes_[index].FirstShape = first;
+				Nodes_[index].ShapeCount = count;
+				return;
+			}
+
+			int axis = 0;
+			Tuple extent = centres.Max - centres.Min;
+			if (extent.Y > extent[axis]) { axis = 1; }
+			if (extent.Z > extent[axis]) { axis = 2; }
+
+			int half = count / 2;
+			std::nth_element(shapes.begin() + first, shapes.begin() + first + half, shapes.begin() + first + count,
+			                 [axis](const BuildShape& lhs, const BuildShape& rhs)
+			                 {
+				                 return lhs.Centre[axis] < rhs.Centre[axis];
+			                 });
+
+			BuildNode(shapes, first, half);
+			int rightChild = static_cast<int>(Nodes_.size());
+			BuildNode(shapes, first + half, count - half);
+
+			// Not kept as a reference from earlier, as building the children can reallocate the nodes.
+			Nodes_[index].RightChild = rightChild;
+		}
+	};
+}
@@ -0,0 +1,122 @@
+module;
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+export module RayTracer:Bounds;
+
+import :Affine;
+import :Matrix;
+import :Ray;
+import :Tuple;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// An axis aligned bounding box. Anything outside of it can be skipped without testing the shape inside.
+	/// </summary>
+	export struct Bounds
+	{
+		static constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+		/// <returns>Bounds containing nothing, which any point extends.</returns>
+		static constexpr Bounds Empty()
+		{
+			return {Tuple::Point(Infinity, Infinity, Infinity), Tuple::Point(-Infinity, -Infinity, -Infinity)};
+		}
+
+		/// <returns>Bounds containing everything, for shapes like planes that go on forever.</returns>
+		static constexpr Bounds Unbounded()
+		{
+			return {Tuple::Point(-Infinity, -Infinity, -Infinity), Tuple::Point(Infinity, Infinity, Infinity)};
+		}
+
+		Tuple Min = Tuple::Point(Infinity, Infinity, Infinity);
+
+		Tuple Max = Tuple::Point(-Infinity, -Infinity, -Infinity);
+
+		bool IsEmpty() const { return Min.X > Max.X || Min.Y > Max.Y || Min.Z > Max.Z; }
+
+		bool IsFinite() const
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (Min[axis] == -Infinity || Max[axis] == Infinity) { return false; }
+			}
+
+			return true;
+		}
+
+		Tuple Centre() const { return Tuple::Point((Min.X + Max.X) / 2, (Min.Y + Max.Y) / 2, (Min.Z + Max.Z) / 2); }
+
+		void Extend(const Tuple& point)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				Min[axis] = std::min(Min[axis], point[axis]);
+				Max[axis] = std::max(Max[axis], point[axis]);
+			}
+		}
+
+		void Extend(const Bounds& bounds)
+		{
+			if (bounds.IsEmpty()) { return; }
+			Extend(bounds.Min);
+			Extend(bounds.Max);
+		}
+
+		/// <summary>
+		/// Transforms all eight corners and fits new axis aligned bounds around them, which can be larger than the
+		/// transformed shape when it's rotated.
+		/// </summary>
+		Bounds Transformed(const Matrix<4>& transform) const { return Transformed(Affine::From(transform)); }
+
+		Bounds Transformed(const Affine& transform) const
+		{
+			if (IsEmpty()) { return *this; }
+			if (!IsFinite()) { return Unbounded(); }
+
+			Bounds transformed;
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				Tuple point = Tuple::Point
+				(
+					(corner & 1) ? Max.X : Min.X,
+					(corner & 2) ? Max.Y : Min.Y,
+					(corner & 4) ? Max.Z : Min.Z
+				);
+				transformed.Extend(transform.TransformPoint(point));
+			}
+
+			return transformed;
+		}
+
+		/// <summary>
+		/// Slab test, clipping the ray against each pair of axis aligned planes in turn.
+		/// </summary>
+		/// <returns>Whether the ray passes through the bounds anywhere between the ray's origin and maxTime.</returns>
+		bool Intersects(const Ray& ray, float maxTime = Infinity) const
+		{
+			float nearest = 0;
+			float farthest = maxTime;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				// Division by zero gives infinity, which the comparisons handle as the ray being parallel to the slab.
+				float inverseDirection = 1.0f / ray.Direction[axis];
+				float t0 = (Min[axis] - ray.Origin[axis]) * inverseDirection;
+				float t1 = (Max[axis] - ray.Origin[axis]) * inverseDirection;
+				if (t0 > t1) { std::swap(t0, t1); }
+
+				// Written so that a NaN, from an origin on an infinite bound, keeps the current interval.
+				nearest = t0 > nearest ? t0 : nearest;
+				farthest = t1 < farthest ? t1 : farthest;
+				if (nearest > farthest) { return false; }
+			}
+
+			return true;
+		}
+
+		bool operator==(const Bounds& rhs) const { return Min == rhs.Min && Max == rhs.Max; }
+	};
+}
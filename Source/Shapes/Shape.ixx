@@ -1,10 +1,13 @@
 module;
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
 export module RayTracer:Shape;
+import :Affine;
+import :Bounds;
 import :Matrix;
 import :Material;
 import :Ray;
@@ -89,20 +92,23 @@ namespace RayTracer
 
 		size_t ID_ = GetFreeID();
 
-	public:
-		Matrix<4> Transform_ = Matrix<4>::IdentityMatrix();
-
-		Material Material_; // Maybe this is why pascal case members aren't so popular in C++...
+		// Row major 3x4, as every shape's transform is affine. Only ever set along with its inverse, by
+		// SetTransform, so the two can't disagree.
+		Affine Transform_ = Affine::Identity();
 
-		Shape() {}
+		Affine InverseTransform_ = Affine::Identity();
 
-		Shape(const Matrix<4>& transform) : Transform_(transform) {}
+		// Where the shape's material is in the material table of the world it's in. The table's first entry is
+		// always the default material, so shapes start out with that.
+		uint32_t MaterialIndex_ = 0;
 
-		Shape(const Matrix<4>& transform, const Material& material) : Transform_(transform), Material_(material) {}
+	public:
+		Shape() {}
 
-		Shape(const Material& material) : Material_(material) {}
+		Shape(const Matrix<4>& transform) { SetTransform(transform); }
 
-		Shape(const Shape& object) : Transform_(object.Transform_), Material_(object.Material_) {}
+		Shape(const Shape& object) : Transform_(object.Transform_), InverseTransform_(object.InverseTransform_),
+			MaterialIndex_(object.MaterialIndex_) {}
 
 		virtual ~Shape() = default;
 
@@ -111,7 +117,7 @@ namespace RayTracer
 			// Rather than contend with transforming objects, making calculations difficult,
 			// instead transform the ray by the inverse transform allowing the object to be treated as a
 			// unit object with its origin as 0,0,0. World-Space vs Object-Space.
-			const Ray transformedRay = ray.Transformed(Transform_.Inverted());
+			const Ray transformedRay = ray.Transformed(InverseTransform());
 
 			return IntersectLocal(transformedRay);
 		}
@@ -121,7 +127,7 @@ namespace RayTracer
 			// To handle a transformed sphere, transform the world space point
 			// to object space so that the sphere can be treated as though it
 			// were a unit sphere. This gets the normal in object space.
-			Tuple objectSpacePoint = Transform_.Inverted() * worldSpacePoint;
+			Tuple objectSpacePoint = InverseTransform().TransformPoint(worldSpacePoint);
 			Tuple localNormal = NormalLocal(objectSpacePoint);
 
 			// To convert from object space to normal space multiply the
@@ -130,12 +136,42 @@ namespace RayTracer
 			// right, but because the normals will no longer be perpendicular to
 			// the surface it'll appear as though the image was transformed,
 			// rather than the object.
-			Tuple worldNormal = Transform_.Inverted().Transposed() * localNormal;
-			worldNormal.W = 0; // Hack to fix any wonky w coordinate caused by a translation transform.
+			// Only the linear part is transposed, so translation can't leave a wonky W coordinate.
+			return InverseTransform().TransformNormal(localNormal).Normalised();
+		}
+
+		Matrix<4> GetTransform() const { return Transform_.ToMatrix(); }
+
+		/// <summary>
+		/// Moves the shape, working out the inverse straight away so that rendering only ever reads it.
+		/// </summary>
+		void SetTransform(const Matrix<4>& transform) { SetTransform(Affine::From(transform)); }
 
-			return worldNormal.Normalised();
+		void SetTransform(const Affine& transform)
+		{
+			Transform_ = transform;
+			InverseTransform_ = transform.Inverted();
 		}
 
+		const Affine& InverseTransform() const { return InverseTransform_; }
+
+		uint32_t GetMaterialIndex() const { return MaterialIndex_; }
+
+		/// <summary>
+		/// Gives the shape a material from its world's material table. World::SetMaterial adds the material to the
+		/// table and sets this along with it.
+		/// </summary>
+		void SetMaterialIndex(uint32_t index) { MaterialIndex_ = index; }
+
+		/// <returns>
+		/// The shape's bounds in world space. Worked out every time, as only building or refitting an acceleration
+		/// structure needs them.
+		/// </returns>
+		Bounds WorldBounds() const { return LocalBounds().Transformed(Transform_); }
+
+		/// <returns>The shape's bounds in object space. Unbounded unless a shape says otherwise.</returns>
+		virtual Bounds LocalBounds() const { return Bounds::Unbounded(); }
+
 	protected:
 		virtual std::vector<Intersection> IntersectLocal(const Ray& ray) = 0;
 
@@ -144,28 +180,30 @@ namespace RayTracer
 	public:
 		// Needed to move this here rather than on pattern object to avoid circular dependency. But really, it makes
 		// more sense here anyway
-		Tuple StripeAt(Tuple worldSpacePoint) const
+		/// <returns>The pattern's colour where it's applied to this shape at the world space point.</returns>
+		Tuple StripeAt(const Pattern& pattern, Tuple worldSpacePoint) const
 		{
-			assert(Material_.Pattern_);
-
-			Tuple objectSpacePoint = Transform_.Inverted() * worldSpacePoint;
-			Tuple patternSpacePoint = Material_.Pattern_->Transform.Inverted() * objectSpacePoint;
+			Tuple objectSpacePoint = InverseTransform().TransformPoint(worldSpacePoint);
+			Tuple patternSpacePoint = pattern.InverseTransform().TransformPoint(objectSpacePoint);
 
-			return Material_.Pattern_->ColourAt(patternSpacePoint);
+			return pattern.ColourAt(patternSpacePoint);
 		}
 
-		Tuple Lighting(const PointLight& light, const Tuple& surfacePointViewed,
+		/// <summary>
+		/// Lights the shape as though it were made of the given material, such as its entry in a material table.
+		/// </summary>
+		Tuple Lighting(const Material& material, const PointLight& light, const Tuple& surfacePointViewed,
 		               const Tuple& viewVector, const Tuple& surfaceNormal, bool inShadow = false) const
 		{
 			assert(viewVector == viewVector.Normalised());
 
-			if (Material_.Pattern_)
+			if (material.Pattern_)
 			{
-				return Material_.Lighting(light, surfacePointViewed, viewVector, surfaceNormal, inShadow,
-				                          StripeAt(surfacePointViewed));
+				return material.Lighting(light, surfacePointViewed, viewVector, surfaceNormal, inShadow,
+				                         StripeAt(*material.Pattern_, surfacePointViewed));
 			}
 
-			return Material_.Lighting(light, surfacePointViewed, viewVector, surfaceNormal, inShadow);
+			return material.Lighting(light, surfacePointViewed, viewVector, surfaceNormal, inShadow);
 		}
 
 		bool operator==(const Shape& rhs) const { return ID_ == rhs.ID_; }
@@ -2,6 +2,7 @@ module;
 #include <vector>
 
 export module RayTracer:Sphere;
+import :Bounds;
 import :Ray;
 import :Tuple;
 import :Shape;
@@ -33,6 +34,8 @@ namespace RayTracer
 			};
 		}
 
+		Bounds LocalBounds() const override { return {Tuple::Point(-1, -1, -1), Tuple::Point(1, 1, 1)}; }
+
 	protected:
 		/// <summary>
 		/// Calculates the normals at the point of contact on the sphere.
@@ -0,0 +1,148 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module RayTracer:Arena;
+
+import :Memory;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Allocates objects one after another in large blocks and frees them all at once when the arena is destroyed,
+	/// rather than each object being its own heap allocation. Objects never move once made, and ones made together
+	/// end up next to each other in memory.\n
+	/// Objects are handed out as plain pointers and belong to the arena, so whatever owns the arena decides how long
+	/// they all live, and passing them around costs nothing. Making objects isn't thread safe.
+	/// </summary>
+	export class Arena
+	{
+		// Run in reverse order of construction when the arena is destroyed, for objects that need destroying.
+		struct Finaliser
+		{
+			void (*Destroy)(void* object);
+
+			void* Object;
+		};
+
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> Memory;
+
+			size_t Size;
+		};
+
+		size_t BlockSize_;
+
+		std::vector<Block> Blocks_;
+
+		// Free space at the end of the newest block.
+		std::byte* Next_ = nullptr;
+
+		std::byte* End_ = nullptr;
+
+		// Kept apart from the objects so that they don't leave gaps between them.
+		std::vector<Finaliser> Finalisers_;
+
+		size_t BytesUsed_ = 0;
+
+		// Every block and the finalisers, counted as scene objects as that's what arenas are used for. Counted whole
+		// rather than object by object, so making an object only touches the count when it needs a new block.
+		TrackedBytes Memory_{MemoryCategory::SceneObjects};
+
+	public:
+		static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+		explicit Arena(size_t blockSize = DefaultBlockSize) : BlockSize_(blockSize) {}
+
+		Arena(const Arena&) = delete;
+
+		Arena& operator=(const Arena&) = delete;
+
+		~Arena()
+		{
+			for (auto finaliser = Finalisers_.rbegin(); finaliser != Finalisers_.rend(); ++finaliser)
+			{
+				finaliser->Destroy(finaliser->Object);
+			}
+		}
+
+		/// <summary>
+		/// Constructs an object in the arena, which destroys it along with everything else it made.
+		/// </summary>
+		template <typename T, typename... Args>
+		T* Make(Args&&... args)
+		{
+			// Room is made first so that adding the finaliser can't throw once the object exists.
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				if (Finalisers_.size() == Finalisers_.capacity())
+				{
+					Finalisers_.reserve(std::max<size_t>(16, 2 * Finalisers_.size()));
+					UpdateMemory();
+				}
+			}
+
+			T* object = new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+			// Only added once the object is constructed, so one that throws isn't destroyed later.
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				Finalisers_.push_back({[](void* o) { static_cast<T*>(o)->~T(); }, object});
+			}
+
+			return object;
+		}
+
+		/// <returns>Bytes handed out to objects so far, including alignment padding.</returns>
+		size_t GetBytesUsed() const { return BytesUsed_; }
+
+		/// <returns>Bytes reserved from the heap in blocks.</returns>
+		size_t GetBytesReserved() const
+		{
+			size_t reserved = 0;
+			for (const Block& block : Blocks_) { reserved += block.Size; }
+
+			return reserved;
+		}
+
+		size_t GetBlockCount() const { return Blocks_.size(); }
+
+	private:
+		void* Allocate(size_t size, size_t alignment)
+		{
+			std::byte* start = Align(Next_, alignment);
+			if (!Next_ || start + size > End_)
+			{
+				// Anything too big for a normal block gets a block of its own.
+				size_t blockSize = std::max(BlockSize_, size + alignment);
+				Blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize});
+				Next_ = Blocks_.back().Memory.get();
+				End_ = Next_ + blockSize;
+				start = Align(Next_, alignment);
+				UpdateMemory();
+			}
+
+			BytesUsed_ += start + size - Next_;
+			Next_ = start + size;
+			return start;
+		}
+
+		void UpdateMemory()
+		{
+			Memory_.Set(GetBytesReserved() + Finalisers_.capacity() * sizeof(Finaliser));
+		}
+
+		static std::byte* Align(std::byte* pointer, size_t alignment)
+		{
+			uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+			return pointer + ((alignment - address % alignment) % alignment);
+		}
+	};
+}
@@ -0,0 +1,150 @@
+module;
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+export module RayTracer:MappedFile;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A file mapped into memory and shared with every other mapping of it, so writes to the memory are writes to the
+	/// file, unmapped when destroyed. Only POSIX systems are supported, elsewhere opening a mapping throws.
+	/// </summary>
+	export class MappedFile
+	{
+		std::byte* Data_ = nullptr;
+
+		size_t Size_ = 0;
+
+		// Whether the file already had at least the mapped size when opened.
+		bool Existed_ = false;
+
+		MappedFile(std::byte* data, size_t size, bool existed) : Data_(data), Size_(size), Existed_(existed) {}
+
+	public:
+		MappedFile() = default;
+
+		MappedFile(const MappedFile&) = delete;
+
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept : Data_(std::exchange(other.Data_, nullptr)),
+			Size_(std::exchange(other.Size_, 0)), Existed_(other.Existed_) {}
+
+		MappedFile& operator=(MappedFile&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Unmap();
+				Data_ = std::exchange(other.Data_, nullptr);
+				Size_ = std::exchange(other.Size_, 0);
+				Existed_ = other.Existed_;
+			}
+			return *this;
+		}
+
+		~MappedFile() { Unmap(); }
+
+		std::byte* GetData() const { return Data_; }
+
+		size_t GetSize() const { return Size_; }
+
+		bool IsOpen() const { return Data_ != nullptr; }
+
+		/// <returns>Whether the file was already big enough when opened, so may hold data from before.</returns>
+		bool Existed() const { return Existed_; }
+
+#if !defined(_WIN32)
+		/// <summary>
+		/// Maps the file at the path, creating it or growing it with zeros to the size if needed.
+		/// </summary>
+		static MappedFile Open(const std::string& path, size_t size)
+		{
+			return Map(::open(path.c_str(), O_RDWR | O_CREAT, 0644), size, "open " + path);
+		}
+
+		/// <summary>
+		/// Maps POSIX shared memory with the name, which starts with a slash, creating it if needed. Shared memory
+		/// lives in RAM rather than on disk, and lasts until unlinked even after every mapping of it has gone.
+		/// </summary>
+		static MappedFile OpenShared(const std::string& name, size_t size)
+		{
+			return Map(::shm_open(name.c_str(), O_RDWR | O_CREAT, 0600), size, "open shared memory " + name);
+		}
+
+		static void UnlinkShared(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+		/// <summary>
+		/// Waits for the bytes in the range to be written to the file, so they survive the machine crashing.
+		/// </summary>
+		void Sync(size_t offset, size_t size) const
+		{
+			// The start has to be on a page boundary, so syncs from the start of the page it's in.
+			size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+			size_t start = offset / pageSize * pageSize;
+			if (::msync(Data_ + start, offset + size - start, MS_SYNC) != 0) { ThrowError("sync"); }
+		}
+
+	private:
+		static MappedFile Map(int handle, size_t size, const std::string& operation)
+		{
+			if (handle < 0) { ThrowError(operation); }
+
+			struct stat status{};
+			bool existed = ::fstat(handle, &status) == 0 && static_cast<size_t>(status.st_size) >= size;
+			if (!existed && ::ftruncate(handle, static_cast<off_t>(size)) != 0)
+			{
+				::close(handle);
+				ThrowError("resize");
+			}
+
+			void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+
+			// The mapping keeps the file open itself.
+			::close(handle);
+			if (data == MAP_FAILED) { ThrowError("map"); }
+
+			return {static_cast<std::byte*>(data), size, existed};
+		}
+
+		[[noreturn]] static void ThrowError(const std::string& operation)
+		{
+			throw std::runtime_error("Mapped file " + operation + " failed: " + std::strerror(errno));
+		}
+
+		void Unmap()
+		{
+			if (Data_) { ::munmap(Data_, Size_); }
+			Data_ = nullptr;
+		}
+#else
+		static MappedFile Open(const std::string&, size_t)
+		{
+			throw std::runtime_error("Mapped files require a POSIX system.");
+		}
+
+		static MappedFile OpenShared(const std::string&, size_t)
+		{
+			throw std::runtime_error("Mapped files require a POSIX system.");
+		}
+
+		static void UnlinkShared(const std::string&) {}
+
+		void Sync(size_t, size_t) const {}
+
+	private:
+		void Unmap() { Data_ = nullptr; }
+#endif
+	};
+}
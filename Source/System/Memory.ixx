@@ -0,0 +1,281 @@
+module;
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <utility>
+
+export module RayTracer:Memory;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// What memory is used for, to attribute it to.
+	/// </summary>
+	export enum class MemoryCategory
+	{
+		// Shapes, patterns and materials, counted by the arenas and tables holding them.
+		SceneObjects,
+
+		// Bounding volume hierarchies.
+		Acceleration,
+
+		// Images and G-buffers.
+		Framebuffers,
+
+		// Rays and intersections held while rendering, which come and go with the render.
+		RayBuffers,
+
+		Count
+	};
+
+	export const char* ToString(MemoryCategory category)
+	{
+		switch (category)
+		{
+		case MemoryCategory::SceneObjects: return "Scene objects";
+		case MemoryCategory::Acceleration: return "Acceleration";
+		case MemoryCategory::Framebuffers: return "Framebuffers";
+		case MemoryCategory::RayBuffers: return "Ray buffers";
+		default: return "Unknown";
+		}
+	}
+
+	/// <summary>
+	/// Current and peak bytes used in each category, as reported by the TrackedBytes the memory's owners keep, and
+	/// by ThreadTrackedBytes once their thread flushes. Off unless enabled, in which case nothing is counted and
+	/// checking costs a single relaxed load. Only memory allocated while enabled is counted, so enabling before
+	/// building the scene counts all of it.
+	/// </summary>
+	export class MemoryTracker
+	{
+		struct Counter
+		{
+			std::atomic<int64_t> Current = 0;
+
+			std::atomic<int64_t> Peak = 0;
+
+			void Add(int64_t bytes)
+			{
+				int64_t current = Current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+				int64_t peak = Peak.load(std::memory_order_relaxed);
+				while (current > peak && !Peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+			}
+		};
+
+		struct State
+		{
+			std::atomic<bool> IsEnabled = false;
+
+			std::array<Counter, static_cast<size_t>(MemoryCategory::Count)> Categories;
+
+			// Kept apart from the categories as the peak total can be less than the sum of their peaks.
+			Counter Total;
+		};
+
+		static State& GetState()
+		{
+			static State state;
+			return state;
+		}
+
+		// Counted by each thread for its ThreadTrackedBytes, without touching the shared counters until flushed.
+		struct ThreadCounter
+		{
+			int64_t Current = 0;
+
+			// The most held at once since last flushed.
+			int64_t Peak = 0;
+
+			// What the shared counters were told was held when last flushed.
+			int64_t Reported = 0;
+		};
+
+		static std::array<ThreadCounter, static_cast<size_t>(MemoryCategory::Count)>& ThisThread()
+		{
+			thread_local std::array<ThreadCounter, static_cast<size_t>(MemoryCategory::Count)> counters;
+			return counters;
+		}
+
+	public:
+		static void Enable() { GetState().IsEnabled.store(true, std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Stops counting new memory. Memory counted already is still uncounted when it's freed.
+		/// </summary>
+		static void Disable() { GetState().IsEnabled.store(false, std::memory_order_relaxed); }
+
+		static bool IsEnabled() { return GetState().IsEnabled.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Adds bytes to, or with a negative count takes them from, a category. Done regardless of whether tracking
+		/// is enabled, so should only be called by TrackedBytes.
+		/// </summary>
+		static void Record(MemoryCategory category, int64_t bytes)
+		{
+			State& state = GetState();
+			state.Categories[static_cast<size_t>(category)].Add(bytes);
+			state.Total.Add(bytes);
+		}
+
+		/// <summary>
+		/// Adds bytes to, or takes them from, this thread's own count for a category, which only reaches the shared
+		/// counters when the thread flushes. Should only be called by ThreadTrackedBytes.
+		/// </summary>
+		static void RecordOnThisThread(MemoryCategory category, int64_t bytes)
+		{
+			ThreadCounter& counter = ThisThread()[static_cast<size_t>(category)];
+			counter.Current += bytes;
+			counter.Peak = std::max(counter.Peak, counter.Current);
+		}
+
+		/// <summary>
+		/// Reports what this thread has counted since it last flushed, going up to the most it held at once before
+		/// coming down to what it holds now, so that the shared peaks include it. Rendering flushes once a tile.
+		/// </summary>
+		static void FlushThisThread()
+		{
+			for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+			{
+				ThreadCounter& counter = ThisThread()[i];
+				if (counter.Peak == counter.Reported && counter.Current == counter.Reported) { continue; }
+
+				Record(static_cast<MemoryCategory>(i), counter.Peak - counter.Reported);
+				Record(static_cast<MemoryCategory>(i), counter.Current - counter.Peak);
+				counter.Reported = counter.Current;
+				counter.Peak = counter.Current;
+			}
+		}
+
+		static size_t GetCurrentBytes(MemoryCategory category)
+		{
+			return GetState().Categories[static_cast<size_t>(category)].Current.load(std::memory_order_relaxed);
+		}
+
+		static size_t GetPeakBytes(MemoryCategory category)
+		{
+			return GetState().Categories[static_cast<size_t>(category)].Peak.load(std::memory_order_relaxed);
+		}
+
+		static size_t GetCurrentTotalBytes() { return GetState().Total.Current.load(std::memory_order_relaxed); }
+
+		static size_t GetPeakTotalBytes() { return GetState().Total.Peak.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Brings every peak down to what's in use now, to measure the peak of what follows.
+		/// </summary>
+		static void ResetPeaks()
+		{
+			State& state = GetState();
+			for (Counter& counter : state.Categories) { counter.Peak.store(counter.Current.load()); }
+			state.Total.Peak.store(state.Total.Current.load());
+		}
+
+		/// <summary>
+		/// Writes a table of the current and peak use of each category and in total, in KiB.
+		/// </summary>
+		static void WriteReport(std::ostream& stream)
+		{
+			auto line = [&](const char* name, size_t current, size_t peak)
+			{
+				stream << std::format("{:<16}{:>14.1f}{:>14.1f}\n", name, current / 1024.0, peak / 1024.0);
+			};
+
+			stream << std::format("{:<16}{:>14}{:>14}\n", "Memory (KiB)", "Current", "Peak");
+			for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+			{
+				MemoryCategory category = static_cast<MemoryCategory>(i);
+				line(ToString(category), GetCurrentBytes(category), GetPeakBytes(category));
+			}
+
+			line("Total", GetCurrentTotalBytes(), GetPeakTotalBytes());
+		}
+	};
+
+	/// <summary>
+	/// Counts memory its owner holds under a category, for as long as it's alive, following its owner through copies
+	/// and moves. Bytes set while tracking is disabled aren't counted.
+	/// </summary>
+	export class TrackedBytes
+	{
+		MemoryCategory Category_;
+
+		// What's been counted, 0 if tracking was disabled when set.
+		size_t Bytes_ = 0;
+
+	public:
+		explicit TrackedBytes(MemoryCategory category, size_t bytes = 0) : Category_(category) { Set(bytes); }
+
+		TrackedBytes(const TrackedBytes& other) : Category_(other.Category_) { Set(other.Bytes_); }
+
+		TrackedBytes(TrackedBytes&& other) noexcept : Category_(other.Category_),
+			Bytes_(std::exchange(other.Bytes_, 0)) {}
+
+		TrackedBytes& operator=(const TrackedBytes& other)
+		{
+			if (this == &other) { return *this; }
+
+			Set(0);
+			Category_ = other.Category_;
+			Set(other.Bytes_);
+			return *this;
+		}
+
+		TrackedBytes& operator=(TrackedBytes&& other) noexcept
+		{
+			if (this == &other) { return *this; }
+
+			Set(0);
+			Category_ = other.Category_;
+			Bytes_ = std::exchange(other.Bytes_, 0);
+			return *this;
+		}
+
+		~TrackedBytes() { Set(0); }
+
+		/// <summary>
+		/// Changes how much memory is held, such as after a buffer grows.
+		/// </summary>
+		void Set(size_t bytes)
+		{
+			if (bytes != 0 && !MemoryTracker::IsEnabled()) { bytes = 0; }
+			if (bytes == Bytes_) { return; }
+
+			MemoryTracker::Record(Category_, static_cast<int64_t>(bytes) - static_cast<int64_t>(Bytes_));
+			Bytes_ = bytes;
+		}
+
+		size_t GetBytes() const { return Bytes_; }
+	};
+
+	/// <summary>
+	/// Counts memory held briefly on one thread, such as a ray's intersections, for as long as it's alive. Unlike
+	/// TrackedBytes it only touches a count kept by the thread, which is added to the shared counts when the thread
+	/// flushes, so that threads making many of these a second don't contend for the shared counters.
+	/// </summary>
+	export class ThreadTrackedBytes
+	{
+		MemoryCategory Category_;
+
+		// What's been counted, 0 if tracking was disabled when made.
+		int64_t Bytes_;
+
+	public:
+		ThreadTrackedBytes(MemoryCategory category, size_t bytes) : Category_(category),
+			Bytes_(MemoryTracker::IsEnabled() ? static_cast<int64_t>(bytes) : 0)
+		{
+			if (Bytes_ != 0) { MemoryTracker::RecordOnThisThread(Category_, Bytes_); }
+		}
+
+		ThreadTrackedBytes(const ThreadTrackedBytes&) = delete;
+
+		ThreadTrackedBytes& operator=(const ThreadTrackedBytes&) = delete;
+
+		~ThreadTrackedBytes()
+		{
+			if (Bytes_ != 0) { MemoryTracker::RecordOnThisThread(Category_, -Bytes_); }
+		}
+	};
+}
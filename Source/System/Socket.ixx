@@ -0,0 +1,341 @@
+module;
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+export module RayTracer:Socket;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A blocking stream socket, closed when destroyed. Addresses are either "unix:/path/to/socket" for a Unix
+	/// domain socket or "host:port" for TCP. Without a host, ":port" is loopback only, and "*:port" listens on every
+	/// interface. Only POSIX systems are supported, elsewhere opening a socket throws.
+	/// </summary>
+	export class Socket
+	{
+		int Handle_ = -1;
+
+		explicit Socket(int handle) : Handle_(handle) {}
+
+	public:
+		static constexpr const char* UnixPrefix = "unix:";
+
+		// Longest string ReceiveString accepts unless told otherwise, so a bad length can't exhaust memory.
+		static constexpr unsigned long long MaxStringSize = 64ull * 1024 * 1024;
+
+		Socket() = default;
+
+		Socket(const Socket&) = delete;
+
+		Socket& operator=(const Socket&) = delete;
+
+		Socket(Socket&& other) noexcept : Handle_(std::exchange(other.Handle_, -1)) {}
+
+		Socket& operator=(Socket&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Close();
+				Handle_ = std::exchange(other.Handle_, -1);
+			}
+			return *this;
+		}
+
+		~Socket() { Close(); }
+
+		int GetHandle() const { return Handle_; }
+
+		bool IsOpen() const { return Handle_ >= 0; }
+
+#if !defined(_WIN32)
+		static Socket Listen(const std::string& address)
+		{
+			if (address.starts_with(UnixPrefix))
+			{
+				sockaddr_un socketAddress = UnixAddress(address);
+				Socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+				socket.ThrowIfClosed("socket");
+
+				// A socket file left behind by a previous run would stop the bind.
+				::unlink(socketAddress.sun_path);
+				if (::bind(socket.Handle_, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0)
+				{
+					ThrowError("bind");
+				}
+				if (::listen(socket.Handle_, SOMAXCONN) != 0) { ThrowError("listen"); }
+				return socket;
+			}
+
+			addrinfo* addresses = ResolveTCP(address, true);
+			Socket socket(::socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol));
+			int reuse = 1;
+			::setsockopt(socket.Handle_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+			bool bound = socket.IsOpen() && ::bind(socket.Handle_, addresses->ai_addr, addresses->ai_addrlen) == 0;
+			::freeaddrinfo(addresses);
+			if (!bound) { ThrowError("bind"); }
+			if (::listen(socket.Handle_, SOMAXCONN) != 0) { ThrowError("listen"); }
+			return socket;
+		}
+
+		static Socket Connect(const std::string& address)
+		{
+			if (address.starts_with(UnixPrefix))
+			{
+				sockaddr_un socketAddress = UnixAddress(address);
+				Socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+				socket.ThrowIfClosed("socket");
+				if (::connect(socket.Handle_, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress))
+					!= 0) { ThrowError("connect"); }
+				return socket;
+			}
+
+			addrinfo* addresses = ResolveTCP(address, false);
+			Socket socket(::socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol));
+			bool connected = socket.IsOpen() &&
+				::connect(socket.Handle_, addresses->ai_addr, addresses->ai_addrlen) == 0;
+			::freeaddrinfo(addresses);
+			if (!connected) { ThrowError("connect"); }
+
+			// Messages are small and latency bound, so don't let Nagle hold them back.
+			int noDelay = 1;
+			::setsockopt(socket.Handle_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+			return socket;
+		}
+
+		Socket Accept() const
+		{
+			Socket socket(::accept(Handle_, nullptr, nullptr));
+			socket.ThrowIfClosed("accept");
+			return socket;
+		}
+
+		/// <summary>
+		/// Makes sends that can't complete within the timeout throw, rather than waiting on the other end forever.
+		/// </summary>
+		void SetSendTimeout(std::chrono::milliseconds timeout) const
+		{
+			timeval time{};
+			time.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+			time.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+			if (::setsockopt(Handle_, SOL_SOCKET, SO_SNDTIMEO, &time, sizeof(time)) != 0) { ThrowError("setsockopt"); }
+		}
+
+		/// <summary>
+		/// Sends all of the data, throwing if the connection fails part way through.
+		/// </summary>
+		void Send(const void* data, size_t size) const
+		{
+			const char* bytes = static_cast<const char*>(data);
+			while (size > 0)
+			{
+				ssize_t sent = ::send(Handle_, bytes, size, SendFlags);
+				if (sent < 0 && errno == EINTR) { continue; }
+				if (sent <= 0) { ThrowError("send"); }
+				bytes += sent;
+				size -= sent;
+			}
+		}
+
+		/// <summary>
+		/// Receives exactly the requested amount of data.
+		/// </summary>
+		/// <returns>False if the other end closed the connection before all of the data arrived.</returns>
+		bool Receive(void* data, size_t size) const
+		{
+			char* bytes = static_cast<char*>(data);
+			while (size > 0)
+			{
+				ssize_t received = ::recv(Handle_, bytes, size, 0);
+				if (received < 0 && errno == EINTR) { continue; }
+				if (received < 0 && errno != ECONNRESET) { ThrowError("recv"); }
+				if (received <= 0) { return false; }
+				bytes += received;
+				size -= received;
+			}
+
+			return true;
+		}
+
+		/// <summary>
+		/// Receives whatever data has already arrived, up to the requested amount, without waiting for more.
+		/// </summary>
+		/// <returns>How much was received, possibly none, or nothing if the other end closed the connection.</returns>
+		std::optional<size_t> ReceiveAvailable(void* data, size_t size) const
+		{
+			if (size == 0) { return 0; }
+
+			while (true)
+			{
+				ssize_t received = ::recv(Handle_, data, size, MSG_DONTWAIT);
+				if (received < 0 && errno == EINTR) { continue; }
+				if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { return 0; }
+				if (received < 0 && errno != ECONNRESET) { ThrowError("recv"); }
+				if (received <= 0) { return {}; }
+				return static_cast<size_t>(received);
+			}
+		}
+
+		/// <summary>
+		/// Waits for any of the sockets to become readable, or to be closed by the other end.
+		/// </summary>
+		/// <returns>The indices of the sockets that are ready, empty if the timeout expired.</returns>
+		static std::vector<size_t> WaitReadable(const std::vector<const Socket*>& sockets, int timeoutMilliseconds)
+		{
+			std::vector<pollfd> descriptors;
+			descriptors.reserve(sockets.size());
+			for (const Socket* socket : sockets) { descriptors.push_back({socket->Handle_, POLLIN, 0}); }
+
+			int result = ::poll(descriptors.data(), descriptors.size(), timeoutMilliseconds);
+			if (result < 0 && errno != EINTR) { ThrowError("poll"); }
+
+			std::vector<size_t> ready;
+			for (size_t i = 0; result > 0 && i < descriptors.size(); ++i)
+			{
+				if (descriptors[i].revents != 0) { ready.push_back(i); }
+			}
+
+			return ready;
+		}
+
+		void Close()
+		{
+			if (Handle_ >= 0) { ::close(Handle_); }
+			Handle_ = -1;
+		}
+
+	private:
+		// Writing to a socket the other end has closed would otherwise kill the process with SIGPIPE.
+#if defined(MSG_NOSIGNAL)
+		static constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+		static constexpr int SendFlags = 0;
+#endif
+
+		[[noreturn]] static void ThrowError(const char* operation)
+		{
+			throw std::runtime_error(std::string("Socket ") + operation + " failed: " + std::strerror(errno));
+		}
+
+		void ThrowIfClosed(const char* operation) const
+		{
+			if (!IsOpen()) { ThrowError(operation); }
+		}
+
+		static sockaddr_un UnixAddress(const std::string& address)
+		{
+			std::string path = address.substr(std::strlen(UnixPrefix));
+
+			sockaddr_un socketAddress{};
+			socketAddress.sun_family = AF_UNIX;
+			if (path.size() >= sizeof(socketAddress.sun_path))
+			{
+				throw std::runtime_error("Socket path is too long: " + path);
+			}
+			std::strcpy(socketAddress.sun_path, path.c_str());
+
+			return socketAddress;
+		}
+
+		static addrinfo* ResolveTCP(const std::string& address, bool passive)
+		{
+			size_t separator = address.rfind(':');
+			if (separator == std::string::npos) { throw std::runtime_error("Socket address has no port: " + address); }
+
+			std::string host = address.substr(0, separator);
+			std::string port = address.substr(separator + 1);
+
+			// Without AI_PASSIVE, no host resolves to loopback. Nothing is exposed to the network unless asked for.
+			bool isEveryInterface = passive && host == "*";
+			addrinfo hints{};
+			hints.ai_family = AF_UNSPEC;
+			hints.ai_socktype = SOCK_STREAM;
+			hints.ai_flags = isEveryInterface ? AI_PASSIVE : 0;
+
+			addrinfo* addresses = nullptr;
+			const char* node = host.empty() || isEveryInterface ? nullptr : host.c_str();
+			int result = ::getaddrinfo(node, port.c_str(), &hints, &addresses);
+			if (result != 0)
+			{
+				throw std::runtime_error("Socket can't resolve " + address + ": " + ::gai_strerror(result));
+			}
+
+			return addresses;
+		}
+#else
+		static Socket Listen(const std::string&) { throw std::runtime_error("Sockets require a POSIX system."); }
+
+		static Socket Connect(const std::string&) { throw std::runtime_error("Sockets require a POSIX system."); }
+
+		Socket Accept() const { throw std::runtime_error("Sockets require a POSIX system."); }
+
+		void Send(const void*, size_t) const { throw std::runtime_error("Sockets require a POSIX system."); }
+
+		void SetSendTimeout(std::chrono::milliseconds) const
+		{
+			throw std::runtime_error("Sockets require a POSIX system.");
+		}
+
+		bool Receive(void*, size_t) const { throw std::runtime_error("Sockets require a POSIX system."); }
+
+		std::optional<size_t> ReceiveAvailable(void*, size_t) const
+		{
+			throw std::runtime_error("Sockets require a POSIX system.");
+		}
+
+		static std::vector<size_t> WaitReadable(const std::vector<const Socket*>&, int)
+		{
+			throw std::runtime_error("Sockets require a POSIX system.");
+		}
+
+		void Close() { Handle_ = -1; }
+#endif
+
+	public:
+		template <typename T>
+		void SendValue(const T& value) const { Send(&value, sizeof(T)); }
+
+		template <typename T>
+		bool ReceiveValue(T& value) const { return Receive(&value, sizeof(T)); }
+
+		void SendString(const std::string& string) const
+		{
+			unsigned long long size = string.size();
+			SendValue(size);
+			Send(string.data(), string.size());
+		}
+
+		/// <summary>
+		/// Receives a string sent by SendString, throwing if it's longer than maxSize.
+		/// </summary>
+		/// <returns>False if the other end closed the connection before all of the string arrived.</returns>
+		bool ReceiveString(std::string& string, unsigned long long maxSize = MaxStringSize) const
+		{
+			unsigned long long size = 0;
+			if (!ReceiveValue(size)) { return false; }
+			if (size > maxSize)
+			{
+				throw std::runtime_error("Socket string of " + std::to_string(size) + " bytes is longer than allowed");
+			}
+
+			string.resize(size);
+			return Receive(string.data(), size);
+		}
+	};
+}
@@ -0,0 +1,152 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+export module RayTracer:ThreadPool;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// A fixed set of threads which run queued tasks. Starting threads isn't free, so renders share one pool that
+	/// stays alive between them rather than starting their own.
+	/// </summary>
+	export class ThreadPool
+	{
+		std::vector<std::thread> Threads_;
+
+		std::deque<std::function<void()>> Tasks_;
+
+		std::mutex Mutex_;
+
+		std::condition_variable TaskAvailable_;
+
+		bool Stopping_ = false;
+
+	public:
+		/// <returns>A pool with a thread per core, created on first use and shared by the whole process.</returns>
+		static ThreadPool& Shared()
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+
+		explicit ThreadPool(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency()))
+		{
+			for (unsigned i = 0; i < threadCount; ++i) { Threads_.emplace_back([this] { WorkerLoop(); }); }
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/// <summary>
+		/// Finishes any queued tasks before joining the threads.
+		/// </summary>
+		~ThreadPool()
+		{
+			{
+				std::lock_guard lock(Mutex_);
+				Stopping_ = true;
+			}
+			TaskAvailable_.notify_all();
+
+			for (std::thread& thread : Threads_) { thread.join(); }
+		}
+
+		size_t GetThreadCount() const { return Threads_.size(); }
+
+		/// <summary>
+		/// Queues a task to be run by one of the pool's threads. Tasks are started in the order they're submitted.
+		/// </summary>
+		void Submit(std::function<void()> task)
+		{
+			{
+				std::lock_guard lock(Mutex_);
+				Tasks_.push_back(std::move(task));
+			}
+			TaskAvailable_.notify_one();
+		}
+
+		/// <summary>
+		/// Calls task with every index from 0 to count - 1, spread across the pool, and waits for them all to finish.
+		/// The calling thread works through indices too rather than just waiting, so calling this from inside one of
+		/// the pool's own tasks can't deadlock. If any call throws, the first exception is rethrown here once the
+		/// others have finished.
+		/// </summary>
+		void ParallelFor(size_t count, const std::function<void(size_t)>& task)
+		{
+			if (count == 0) { return; }
+
+			struct Loop
+			{
+				std::atomic<size_t> Next = 0;
+
+				std::atomic<size_t> Finished = 0;
+
+				std::mutex Mutex;
+
+				std::condition_variable Done;
+
+				std::exception_ptr Exception;
+			};
+
+			// Shared as helpers that only get to start after the loop has finished still look at it.
+			std::shared_ptr<Loop> loop = std::make_shared<Loop>();
+
+			auto work = [loop, count, &task]
+			{
+				for (size_t i = loop->Next++; i < count; i = loop->Next++)
+				{
+					try { task(i); }
+					catch (...)
+					{
+						std::lock_guard lock(loop->Mutex);
+						if (!loop->Exception) { loop->Exception = std::current_exception(); }
+					}
+
+					if (++loop->Finished == count)
+					{
+						std::lock_guard lock(loop->Mutex);
+						loop->Done.notify_all();
+					}
+				}
+			};
+
+			size_t helpers = std::min(Threads_.size(), count - 1);
+			for (size_t i = 0; i < helpers; ++i) { Submit(work); }
+
+			work();
+
+			std::unique_lock lock(loop->Mutex);
+			loop->Done.wait(lock, [&] { return loop->Finished == count; });
+			if (loop->Exception) { std::rethrow_exception(loop->Exception); }
+		}
+
+	private:
+		void WorkerLoop()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock lock(Mutex_);
+					TaskAvailable_.wait(lock, [this] { return Stopping_ || !Tasks_.empty(); });
+					if (Tasks_.empty()) { return; }
+
+					task = std::move(Tasks_.front());
+					Tasks_.pop_front();
+				}
+
+				task();
+			}
+		}
+	};
+}
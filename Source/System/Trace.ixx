@@ -0,0 +1,212 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+export module RayTracer:Trace;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Records how long named pieces of work take on each thread, written out in Chrome's trace event format to be
+	/// viewed in chrome://tracing or Perfetto.\n
+	/// Each thread records into its own buffer without locking, so recording barely changes the timings being
+	/// recorded. Does nothing unless started.
+	/// </summary>
+	export class Trace
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/// <summary>
+		/// A piece of work, optionally on a tile of the image.
+		/// </summary>
+		struct Event
+		{
+			// Written as is, so expected to be a string literal without anything that needs escaping in JSON.
+			const char* Name;
+
+			Clock::time_point Start;
+
+			Clock::time_point End;
+
+			bool HasTile = false;
+
+			int TileX = 0;
+
+			int TileY = 0;
+
+			int TileWidth = 0;
+
+			int TileHeight = 0;
+		};
+
+	private:
+		struct ThreadBuffer
+		{
+			int ThreadID;
+
+			std::vector<Event> Events;
+		};
+
+		struct State
+		{
+			std::atomic<bool> IsRecording = false;
+
+			Clock::time_point Origin = Clock::now();
+
+			// Only locked when a thread records for the first time, and when starting or writing.
+			std::mutex Mutex;
+
+			// Kept for the life of the process, so that a thread's buffer outlives the thread.
+			std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+		};
+
+		static State& GetState()
+		{
+			static State state;
+			return state;
+		}
+
+		static ThreadBuffer& GetThreadBuffer()
+		{
+			thread_local ThreadBuffer* buffer = nullptr;
+			if (!buffer)
+			{
+				State& state = GetState();
+				std::lock_guard lock(state.Mutex);
+				state.Buffers.push_back(std::make_unique<ThreadBuffer>());
+				buffer = state.Buffers.back().get();
+				buffer->ThreadID = static_cast<int>(state.Buffers.size());
+
+				// Enough for most renders without having to grow while recording.
+				buffer->Events.reserve(4096);
+			}
+
+			return *buffer;
+		}
+
+	public:
+		/// <summary>
+		/// Discards anything recorded before and starts recording. Not to be called while anything is being
+		/// recorded.
+		/// </summary>
+		static void Start()
+		{
+			State& state = GetState();
+			std::lock_guard lock(state.Mutex);
+			for (const std::unique_ptr<ThreadBuffer>& buffer : state.Buffers) { buffer->Events.clear(); }
+			state.Origin = Clock::now();
+			state.IsRecording.store(true, std::memory_order_release);
+		}
+
+		static void Stop() { GetState().IsRecording.store(false, std::memory_order_release); }
+
+		static bool IsRecording() { return GetState().IsRecording.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Adds an event to the calling thread's buffer, if recording.
+		/// </summary>
+		static void Record(const Event& event)
+		{
+			if (IsRecording()) { GetThreadBuffer().Events.push_back(event); }
+		}
+
+		/// <returns>How many events have been recorded across every thread since starting.</returns>
+		static size_t GetEventCount()
+		{
+			State& state = GetState();
+			std::lock_guard lock(state.Mutex);
+
+			size_t count = 0;
+			for (const std::unique_ptr<ThreadBuffer>& buffer : state.Buffers) { count += buffer->Events.size(); }
+
+			return count;
+		}
+
+		/// <summary>
+		/// Writes everything recorded as a Chrome trace event JSON document, with times in microseconds from when
+		/// recording started. Should be called after stopping, once the work being recorded has finished.
+		/// </summary>
+		static void WriteJSON(std::ostream& stream)
+		{
+			State& state = GetState();
+			std::lock_guard lock(state.Mutex);
+
+			auto microseconds = [&](Clock::duration duration)
+			{
+				return std::chrono::duration<double, std::micro>(duration).count();
+			};
+
+			stream << std::fixed << std::setprecision(3);
+			stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+			bool isFirst = true;
+			for (const std::unique_ptr<ThreadBuffer>& buffer : state.Buffers)
+			{
+				if (buffer->Events.empty()) { continue; }
+
+				stream << (isFirst ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+					<< buffer->ThreadID << ",\"args\":{\"name\":\"Thread " << buffer->ThreadID << "\"}}";
+				isFirst = false;
+
+				for (const Event& event : buffer->Events)
+				{
+					stream << ",\n{\"name\":\"" << event.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+						<< buffer->ThreadID << ",\"ts\":" << microseconds(event.Start - state.Origin)
+						<< ",\"dur\":" << microseconds(event.End - event.Start);
+
+					if (event.HasTile)
+					{
+						stream << ",\"args\":{\"x\":" << event.TileX << ",\"y\":" << event.TileY << ",\"width\":"
+							<< event.TileWidth << ",\"height\":" << event.TileHeight << '}';
+					}
+
+					stream << '}';
+				}
+			}
+
+			stream << "\n]}\n";
+		}
+	};
+
+	/// <summary>
+	/// Records the time from its construction to its destruction as an event, if tracing is recording when it's
+	/// constructed.
+	/// </summary>
+	export class TraceScope
+	{
+		Trace::Event Event_;
+
+		bool IsRecording_;
+
+	public:
+		explicit TraceScope(const char* name) : Event_{name}, IsRecording_(Trace::IsRecording())
+		{
+			if (IsRecording_) { Event_.Start = Trace::Clock::now(); }
+		}
+
+		TraceScope(const char* name, int tileX, int tileY, int tileWidth, int tileHeight) :
+			Event_{name, {}, {}, true, tileX, tileY, tileWidth, tileHeight}, IsRecording_(Trace::IsRecording())
+		{
+			if (IsRecording_) { Event_.Start = Trace::Clock::now(); }
+		}
+
+		TraceScope(const TraceScope&) = delete;
+
+		TraceScope& operator=(const TraceScope&) = delete;
+
+		~TraceScope()
+		{
+			if (!IsRecording_) { return; }
+
+			Event_.End = Trace::Clock::now();
+			Trace::Record(Event_);
+		}
+	};
+}
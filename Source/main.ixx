@@ -1,7 +1,13 @@
+#include<fstream>
 #include<iostream>
+#include<map>
 #include<numbers>
 #include<optional>
+#include<sstream>
+#include<string>
+#include<vector>
 import RayTracer;
+import RayTracer.ReferenceScenes;
 
 struct Projectile
 {
@@ -127,7 +133,7 @@ void DrawSphere()
 	{
 		RayTracer::Matrix<4>::Scaling(128, 128, 128).Translate(width / 2, height / 2, 0)
 	};
-	sphere.Material_.Colour = RayTracer::Tuple::Colour(1, 0.2, 1);
+	RayTracer::Material material{RayTracer::Tuple::Colour(1, 0.2, 1)};
 
 	// World Position: X=256, Y=256, Z=512.
 	RayTracer::Ray ray
@@ -151,7 +157,7 @@ void DrawSphere()
 				RayTracer::Tuple position = ray.Position(hit->Time);
 				RayTracer::Tuple normal = hitObject.Normal(position);
 				RayTracer::Tuple eye = -ray.Direction;
-				RayTracer::Tuple surfaceColour = hitObject.Material_.Lighting
+				RayTracer::Tuple surfaceColour = material.Lighting
 				(
 					light,
 					position,
@@ -168,204 +174,196 @@ void DrawSphere()
 
 void DrawSpheres()
 {
-	std::shared_ptr<RayTracer::Sphere> floor = std::make_shared<RayTracer::Sphere>();
-	floor->Transform_.Scale(10, 0.03, 10);
-	floor->Material_.Colour = RayTracer::Tuple::Colour(1, 0.9, 0.9);
-	floor->Material_.Specular = 0;
-
-	std::shared_ptr<RayTracer::Sphere> leftWall = std::make_shared<RayTracer::Sphere>();
-	leftWall->Transform_.Scale(10, 0.03, 10)
-	        .RotateX(std::numbers::pi / 2).RotateY(-std::numbers::pi / 4)
-	        .Translate(0, 0, 5);
-	leftWall->Material_ = floor->Material_;
-
-	std::shared_ptr<RayTracer::Sphere> rightWall = std::make_shared<RayTracer::Sphere>();
-	rightWall->Transform_.Scale(10, 0.03, 10)
-	         .RotateX(std::numbers::pi / 2).RotateY(std::numbers::pi / 4)
-	         .Translate(0, 0, 5);
-	rightWall->Material_ = floor->Material_;
-
-	std::shared_ptr<RayTracer::Sphere> middle = std::make_shared<RayTracer::Sphere>();
-	middle->Transform_.Translate(-0.5, 1, 0.5);
-	middle->Material_.Colour = RayTracer::Tuple::Colour(0.5, 1, 0.1);
-	middle->Material_.Diffuse = 0.7;
-	middle->Material_.Specular = 0.3;
-
-	std::shared_ptr<RayTracer::Sphere> right = std::make_shared<RayTracer::Sphere>();
-	right->Transform_.Scale(0.5, 0.5, 0.5).Translate(1.5, 0.5, 0.1);
-	right->Material_.Colour = RayTracer::Tuple::Colour(0.5, 1, 0.1);
-	right->Material_.Diffuse = 0.7;
-	right->Material_.Specular = 0.3;
-
-	std::shared_ptr<RayTracer::Sphere> left = std::make_shared<RayTracer::Sphere>();
-	left->Transform_.Scale(0.33, 0.33, 0.33).Translate(-1.5, 0.33, -0.75);
-	left->Material_.Colour = RayTracer::Tuple::Colour(1, 0.8, 0.1);
-	left->Material_.Diffuse = 0.7;
-	left->Material_.Specular = 0.3;
-
-	RayTracer::World world
-	{
-		{floor, leftWall, rightWall, left, middle, right},
-		RayTracer::PointLight
-		{
-			RayTracer::Tuple::Point(-10, 10, -10),
-			RayTracer::Tuple::Colour(1, 1, 1)
-		}
-	};
-
-	// TODO: Does it even make sense to have a camera not attached to a world?
-	RayTracer::Camera camera(512, 512, std::numbers::pi / 3);
-	camera.Transform = RayTracer::Matrix<4>::ViewTransform
-	(
-		RayTracer::Tuple::Point(0, 1.5, -5),
-		RayTracer::Tuple::Point(0, 1, 0),
-		RayTracer::Tuple::Vector(0, 1, 0)
-	);
-
-	RayTracer::Canvas canvas = camera.Render(world);
-	canvas.WritePPM();
+	RayTracer::Scene scene = RayTracer::ReferenceScenes::Spheres();
+	scene.Camera_.Render(scene.World_).WritePPM();
 }
 
 void Chapter9()
 {
-	std::shared_ptr<RayTracer::Plane> floor = std::make_shared<RayTracer::Plane>();
-	floor->Material_.Colour = RayTracer::Tuple::Colour(1, 0.9, 0.9);
-	floor->Material_.Specular = 0;
-
-	std::shared_ptr<RayTracer::Sphere> middle = std::make_shared<RayTracer::Sphere>();
-	middle->Transform_.Translate(-0.5, 1, 0.5);
-	middle->Material_.Colour = RayTracer::Tuple::Colour(0.5, 1, 0.1);
-	middle->Material_.Diffuse = 0.7;
-	middle->Material_.Specular = 0.3;
-
-	std::shared_ptr<RayTracer::Sphere> right = std::make_shared<RayTracer::Sphere>();
-	right->Transform_.Scale(0.5, 0.5, 0.5).Translate(1.5, 0.5, 0.1);
-	right->Material_.Colour = RayTracer::Tuple::Colour(0.5, 1, 0.1);
-	right->Material_.Diffuse = 0.7;
-	right->Material_.Specular = 0.3;
-
-	std::shared_ptr<RayTracer::Sphere> left = std::make_shared<RayTracer::Sphere>();
-	left->Transform_.Scale(0.33, 0.33, 0.33).Translate(-1.5, 0.33, -0.75);
-	left->Material_.Colour = RayTracer::Tuple::Colour(1, 0.8, 0.1);
-	left->Material_.Diffuse = 0.7;
-	left->Material_.Specular = 0.3;
-
-	RayTracer::World world
-	{
-		{floor, left, middle, right},
-		RayTracer::PointLight
-		{
-			RayTracer::Tuple::Point(-10, 10, -10),
-			RayTracer::Tuple::Colour(1, 1, 1)
-		}
-	};
-
-	// TODO: Does it even make sense to have a camera not attached to a world?
-	RayTracer::Camera camera(512, 512, std::numbers::pi / 3);
-	camera.Transform = RayTracer::Matrix<4>::ViewTransform
-	(
-		RayTracer::Tuple::Point(0, 1.5, -5),
-		RayTracer::Tuple::Point(0, 1, 0),
-		RayTracer::Tuple::Vector(0, 1, 0)
-	);
-
-	RayTracer::Canvas canvas = camera.Render(world);
-	canvas.WritePPM();
+	RayTracer::Scene scene = RayTracer::ReferenceScenes::Planes();
+	scene.Camera_.Render(scene.World_).WritePPM();
 }
 
 void Chapter10()
 {
-	std::shared_ptr<RayTracer::Plane> floor = std::make_shared<RayTracer::Plane>();
-	floor->Material_.Colour = RayTracer::Tuple::Colour(1, 0.9, 0.9);
-	floor->Material_.Specular = 0;
-	floor->Material_.Pattern_ = std::make_shared<RayTracer::GradientPattern>(RayTracer::Colour::Red,
-	                                                                         RayTracer::Colour::Green);
-	floor->Material_.Pattern_->Transform.Scale(10, 10, 10).Translate(5, 0, 0);
-
-	std::shared_ptr<RayTracer::Plane> backWall = std::make_shared<RayTracer::Plane>();
-	backWall->Transform_.RotateX(-std::numbers::pi / 2).Translate(0, 0, 3);
-	backWall->Material_.Colour = RayTracer::Tuple::Colour(1, 0.9, 0.9);
-
-	std::shared_ptr<RayTracer::Sphere> middle = std::make_shared<RayTracer::Sphere>();
-	middle->Transform_.Translate(-0.5, 1, 0.5);
-	middle->Material_.Colour = RayTracer::Tuple::Colour(0.5, 1, 0.1);
-	middle->Material_.Diffuse = 0.7;
-	middle->Material_.Specular = 0.3;
-	middle->Material_.Pattern_ = std::make_shared<RayTracer::StripePattern>(RayTracer::Colour::White,
-	                                                                        RayTracer::Colour::Black);
-	middle->Material_.Pattern_->Transform.Scale(0.25, 0.25, 0.25);
-
-	std::shared_ptr<RayTracer::Sphere> right = std::make_shared<RayTracer::Sphere>();
-	right->Transform_.Scale(0.5, 0.5, 0.5).Translate(1, 1, 1);
-	right->Material_.Colour = RayTracer::Tuple::Colour(0.5, 1, 0.1);
-	right->Material_.Diffuse = 0.7;
-	right->Material_.Specular = 0.3;
-	right->Material_.Pattern_ = std::make_shared<RayTracer::RingPattern>(RayTracer::Colour::Red,
-	                                                                     RayTracer::Tuple::Colour(1, 0.75, 0.75));
-	right->Material_.Pattern_->Transform.Scale(0.25, 0.25, 0.25).RotateX(std::numbers::pi / 2);
-
-	std::shared_ptr<RayTracer::Sphere> left = std::make_shared<RayTracer::Sphere>();
-	left->Transform_.Scale(0.33, 0.33, 0.33).Translate(-1.5, 0.33, -0.75);
-	left->Material_.Colour = RayTracer::Tuple::Colour(1, 0.8, 0.1);
-	left->Material_.Diffuse = 0.7;
-	left->Material_.Specular = 0.3;
-	left->Material_.Pattern_ = std::make_shared<RayTracer::CheckerPattern>(RayTracer::Colour::Blue,
-	                                                                       RayTracer::Tuple::Colour(0.75, 0.75, 1));
-
-	RayTracer::World world
-	{
-		{floor, backWall, left, middle, right},
-		RayTracer::PointLight
-		{
-			RayTracer::Tuple::Point(-10, 10, -10),
-			RayTracer::Tuple::Colour(1, 1, 1)
-		}
-	};
+	RayTracer::Scene scene = RayTracer::ReferenceScenes::Patterns();
+	scene.Camera_.Render(scene.World_).WritePPM();
+}
 
-	// TODO: Does it even make sense to have a camera not attached to a world?
-	RayTracer::Camera camera(128, 128, std::numbers::pi / 3);
-	camera.Transform = RayTracer::Matrix<4>::ViewTransform
-	(
-		RayTracer::Tuple::Point(0, 1.5, -5),
-		RayTracer::Tuple::Point(0, 1, 0),
-		RayTracer::Tuple::Vector(0, 1, 0)
-	);
+RayTracer::Scene ExampleScene()
+{
+	return RayTracer::ReferenceScenes::Mirrors();
+}
 
-	RayTracer::Canvas canvas = camera.Render(world);
+void ExampleWorld()
+{
+	RayTracer::Scene scene = [] { RayTracer::TraceScope trace("Build scene"); return ExampleScene(); }();
+	RayTracer::Canvas canvas = scene.Camera_.Render(scene.World_);
 	canvas.WritePPM();
 }
 
-void ExampleWorld()
+// Renders the example scene across worker processes started from this executable.
+void ExampleWorldDistributed(const std::string& executable, const std::string& address, int workers)
 {
-	RayTracer::World world;
-	world.Light = RayTracer::PointLight{RayTracer::Tuple::Point(0, 0, 0), RayTracer::Colour::White};
-	RayTracer::Shape& lower = *world.Objects.emplace_back(std::make_shared<RayTracer::Plane>());
-	lower.Material_.Reflectiveness = 1;
-	lower.Transform_.Translate(0, -1, 0);
-
-	RayTracer::Shape& upper = *world.Objects.emplace_back(std::make_shared<RayTracer::Plane>());
-	upper.Material_.Reflectiveness = 1;
-	upper.Transform_.RotateX(-std::numbers::pi).Translate(0, 1, 0);
-
-	RayTracer::Shape& sphere = *world.Objects.emplace_back(std::make_shared<RayTracer::Sphere>());
-	sphere.Transform_.Scale(0.5, 0.5, 0.5).Translate(0, 0, 1);
-
-	RayTracer::Camera camera(128, 128,
-	                         std::numbers::pi / 3,
-	                         RayTracer::Matrix<4>::ViewTransform
-	                         (
-		                         RayTracer::Tuple::Point(0, 0, -5),
-		                         RayTracer::Tuple::Point(0, 0, 1),
-		                         RayTracer::Tuple::Vector(0, 1, 0)
-	                         )
-	);
-
-	RayTracer::Canvas canvas = camera.Render(world);
+	RayTracer::Coordinator coordinator(address);
+	coordinator.SpawnLocalWorkers(executable, workers);
+
+	RayTracer::Canvas canvas = coordinator.Render(ExampleScene());
 	canvas.WritePPM();
 }
 
-int main(int, char**)
+int main(int argc, char** argv)
 {
+	std::vector<std::string> arguments(argv, argv + argc);
+
+	// RayTracer --worker <address>
+	if (arguments.size() == 3 && arguments[1] == "--worker")
+	{
+		RayTracer::Worker::Run(arguments[2]);
+		return 0;
+	}
+
+	// RayTracer --coordinator <address> <worker count>
+	if (arguments.size() == 4 && arguments[1] == "--coordinator")
+	{
+		ExampleWorldDistributed(arguments[0], arguments[2], std::stoi(arguments[3]));
+		return 0;
+	}
+
+	// RayTracer --daemon unix:<path>, keeps scenes loaded and renders them on request until stopped.
+	if (arguments.size() == 3 && arguments[1] == "--daemon")
+	{
+		RayTracer::RenderDaemon daemon(arguments[2]);
+		daemon.Run();
+		return 0;
+	}
+
+	// RayTracer --request <address> <request...>, sends a request to a daemon and prints its answer.
+	if (arguments.size() >= 4 && arguments[1] == "--request")
+	{
+		std::string request = arguments[3];
+		for (size_t i = 4; i < arguments.size(); ++i) { request += ' ' + arguments[i]; }
+
+		std::string answer = RayTracer::RenderDaemon::Request(arguments[2], request);
+		std::cout << answer << std::endl;
+		return answer.starts_with("ok") ? 0 : 1;
+	}
+
+	// RayTracer --trace <file>, renders the example world recording a Chrome trace of where the time went.
+	if (arguments.size() == 3 && arguments[1] == "--trace")
+	{
+		RayTracer::Trace::Start();
+		ExampleWorld();
+		RayTracer::Trace::Stop();
+
+		std::ofstream trace(arguments[2]);
+		RayTracer::Trace::WriteJSON(trace);
+		return 0;
+	}
+
+	// RayTracer --stream <file> <width> <height>, renders the example world a band at a time straight into a
+	// binary PPM, for images too big to hold in memory. Files ending .raw get raw floats instead, for --grade.
+	if (arguments.size() == 5 && arguments[1] == "--stream")
+	{
+		RayTracer::Scene scene = RayTracer::ReferenceScenes::Mirrors(std::stoi(arguments[3]), std::stoi(arguments[4]));
+		RayTracer::StreamFormat format = arguments[2].ends_with(".raw")
+			? RayTracer::StreamFormat::RawFloat : RayTracer::StreamFormat::BinaryPPM;
+		scene.Camera_.RenderStreaming(scene.World_, arguments[2], format);
+		return 0;
+	}
+
+	// RayTracer --checkpoint <file>, renders the example world keeping finished tiles in the file, resuming from it
+	// if it's there from an earlier run that didn't finish.
+	if (arguments.size() == 3 && arguments[1] == "--checkpoint")
+	{
+		RayTracer::Scene scene = ExampleScene();
+		std::ostringstream sceneText;
+		scene.Write(sceneText);
+
+		const RayTracer::Camera& camera = scene.Camera_;
+		RayTracer::Checkpoint checkpoint(arguments[2], camera.RenderWidth, camera.RenderHeight,
+		                                 RayTracer::Camera::TileSize,
+		                                 RayTracer::Checkpoint::SceneKey(sceneText.str()));
+		camera.Render(scene.World_, checkpoint).WritePPM();
+		return 0;
+	}
+
+	// RayTracer --processes <count>, renders the example world across forked processes sharing one framebuffer.
+	if (arguments.size() == 3 && arguments[1] == "--processes")
+	{
+		RayTracer::Scene scene = ExampleScene();
+		RayTracer::MultiProcessRenderer renderer(std::stoi(arguments[2]));
+		RayTracer::Canvas image = renderer.Render(scene.Camera_, scene.World_);
+		for (const RayTracer::ProcessFailure& failure : renderer.GetFailures())
+		{
+			std::cerr << failure.Describe() << ", its unfinished tiles were rendered by the parent." << std::endl;
+		}
+
+		image.WritePPM();
+		return 0;
+	}
+
+	// RayTracer --grade <raw file> <width> <height> <ppm file> <exposure> <none|reinhard|aces> [bloom strength],
+	// grades an image streamed as raw floats for display, as sRGB with dithering, without tracing it again.
+	if ((arguments.size() == 8 || arguments.size() == 9) && arguments[1] == "--grade")
+	{
+		const std::map<std::string, RayTracer::ToneMapper> toneMappers =
+		{
+			{"none", RayTracer::ToneMapper::None},
+			{"reinhard", RayTracer::ToneMapper::Reinhard},
+			{"aces", RayTracer::ToneMapper::ACES}
+		};
+		auto toneMapper = toneMappers.find(arguments[7]);
+		if (toneMapper == toneMappers.end())
+		{
+			std::cerr << "Unknown tone mapper " << arguments[7] << std::endl;
+			return 1;
+		}
+
+		RayTracer::PostProcessSettings settings;
+		settings.Exposure = std::stof(arguments[6]);
+		settings.ToneMap = toneMapper->second;
+		settings.Transfer = RayTracer::TransferFunction::SRGB;
+		settings.Dither = true;
+		if (arguments.size() == 9) { settings.BloomStrength = std::stof(arguments[8]); }
+
+		RayTracer::Canvas image = RayTracer::Canvas::ReadRawFloat(arguments[2], std::stoi(arguments[3]),
+		                                                          std::stoi(arguments[4]));
+		RayTracer::PostProcess::Apply(image, settings).WritePPM(arguments[5]);
+		return 0;
+	}
+
+	// RayTracer --memory, renders the example world then reports the memory it used.
+	if (arguments.size() == 2 && arguments[1] == "--memory")
+	{
+		RayTracer::MemoryTracker::Enable();
+		ExampleWorld();
+		RayTracer::MemoryTracker::WriteReport(std::cout);
+		return 0;
+	}
+
+	// RayTracer --heatmap <time|tests|rays|depth>, renders the example world showing what each pixel cost.
+	if (arguments.size() == 3 && arguments[1] == "--heatmap")
+	{
+		const std::map<std::string, RayTracer::HeatmapMetric> metrics =
+		{
+			{"time", RayTracer::HeatmapMetric::Nanoseconds},
+			{"tests", RayTracer::HeatmapMetric::IntersectionTests},
+			{"rays", RayTracer::HeatmapMetric::Rays},
+			{"depth", RayTracer::HeatmapMetric::Depth}
+		};
+		auto metric = metrics.find(arguments[2]);
+		if (metric == metrics.end())
+		{
+			std::cerr << "Unknown heatmap metric " << arguments[2] << std::endl;
+			return 1;
+		}
+
+		RayTracer::Scene scene = ExampleScene();
+		scene.Camera_.RenderHeatmap(scene.World_, metric->second).WritePPM();
+		return 0;
+	}
+
 	// Z: Forward, Y: Up, X: Right
 	ExampleWorld();
 	return 0;
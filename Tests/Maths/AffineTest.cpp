@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include <numbers>
+import RayTracer;
+
+namespace RayTracer
+{
+	Matrix<4> ExampleTransform()
+	{
+		return Matrix<4>::IdentityMatrix().Scale(2, 3, 0.5f).Shear(1, 0, 0, 0.5f, 0, 0)
+			.RotateY(std::numbers::pi / 3).Translate(5, -3, 2);
+	}
+
+	TEST(AffineTest, RoundTripsMatrix)
+	{
+		Matrix<4> matrix = ExampleTransform();
+		ASSERT_EQ(Affine::From(matrix).ToMatrix(), matrix);
+	}
+
+	TEST(AffineTest, TransformPointMatchesMatrix)
+	{
+		Matrix<4> matrix = ExampleTransform();
+		Tuple point = Tuple::Point(-4, 6, 8);
+		ASSERT_EQ(Affine::From(matrix).TransformPoint(point), matrix * point);
+	}
+
+	TEST(AffineTest, TransformVectorIgnoresTranslation)
+	{
+		Affine translation = Affine::From(Matrix<4>::Translation(5, -3, 2));
+		Tuple vector = Tuple::Vector(-3, 4, 5);
+		ASSERT_EQ(translation.TransformVector(vector), vector);
+	}
+
+	TEST(AffineTest, InvertedMatchesMatrix)
+	{
+		Matrix<4> matrix = ExampleTransform();
+		ASSERT_EQ(Affine::From(matrix).Inverted(), Affine::From(matrix.Inverted()));
+		ASSERT_EQ(Affine::From(matrix).Inverted() * Affine::From(matrix), Affine::Identity());
+	}
+
+	TEST(AffineTest, CompositionMatchesMatrix)
+	{
+		Matrix<4> lhs = Matrix<4>::RotationX(std::numbers::pi / 4).Translated(1, 2, 3);
+		Matrix<4> rhs = ExampleTransform();
+		ASSERT_EQ(Affine::From(lhs) * Affine::From(rhs), Affine::From(lhs * rhs));
+	}
+
+	TEST(AffineTest, TransformNormalMatchesInverseTranspose)
+	{
+		Matrix<4> inverse = ExampleTransform().Inverted();
+		Tuple normal = Tuple::Vector(0, std::numbers::sqrt2 / 2, -std::numbers::sqrt2 / 2);
+
+		Tuple expected = inverse.Transposed() * normal;
+		expected.W = 0;
+		ASSERT_EQ(Affine::From(inverse).TransformNormal(normal), expected);
+	}
+}
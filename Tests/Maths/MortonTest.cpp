@@ -0,0 +1,25 @@
+#include "gtest/gtest.h"
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(MortonTest, Interleaves2D)
+	{
+		ASSERT_EQ(MortonCode(0, 0), 0);
+		ASSERT_EQ(MortonCode(1, 0), 1);
+		ASSERT_EQ(MortonCode(0, 1), 2);
+		ASSERT_EQ(MortonCode(3, 3), 15);
+		ASSERT_EQ(MortonCode(0xffff, 0), 0x55555555);
+		ASSERT_EQ(MortonCode(0, 0xffff), 0xaaaaaaaa);
+	}
+
+	TEST(MortonTest, Interleaves3D)
+	{
+		ASSERT_EQ(MortonCode(1, 0, 0), 1);
+		ASSERT_EQ(MortonCode(0, 1, 0), 2);
+		ASSERT_EQ(MortonCode(0, 0, 1), 4);
+		ASSERT_EQ(MortonCode(2, 0, 0), 8);
+		ASSERT_EQ(MortonCode(1023, 1023, 1023), 0x3fffffff);
+	}
+}
@@ -0,0 +1,215 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+import RayTracer;
+import RayTracer.ReferenceScenes;
+
+namespace RayTracer
+{
+	/// <summary>
+	/// Set from the command line, which CMake fills in when registering the test.
+	/// </summary>
+	struct RegressionOptions
+	{
+		// Where the golden images are kept, one PPM per reference scene named after it.
+		std::string GoldenDirectory = "Golden";
+
+		// Render times to compare against, one scene per line as its name then its time relative to the
+		// calibration workload.
+		std::string BaselinePath = "RenderBaseline.txt";
+
+		// How much slower than its baseline a scene can render before failing, as a percentage. Allows for machines
+		// differing in more than speed, as the baseline is only relative to one workload.
+		float MaxSlowdown = 100;
+
+		// Images any further from their golden image than this fail.
+		float MinPSNR = 40;
+
+		// Writes the golden images from this build's renders rather than checking against them.
+		bool UpdateGolden = false;
+
+		// Writes the baseline from this build's render times rather than checking against it.
+		bool UpdateBaseline = false;
+	};
+
+	RegressionOptions Options;
+
+	// Small enough to keep the golden images in the repository, large enough to show any change in shading.
+	constexpr int GoldenSize = 64;
+
+	// Large enough for the render time to be measured reliably.
+	constexpr int TimingSize = 256;
+
+	constexpr int TimingRuns = 5;
+
+	template <typename Function>
+	float Milliseconds(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	/// <summary>
+	/// A fixed amount of floating point work that uses nothing of the renderer, so that render times can be kept
+	/// relative to how fast the machine is and a baseline recorded on one machine holds on another.
+	/// </summary>
+	void CalibrationWorkload()
+	{
+		float value = 0.5f;
+		float sum = 0;
+		for (int i = 0; i < 20'000'000; ++i)
+		{
+			value = value * 1.0001f + 0.0001f;
+			if (value > 1) { value -= 1; }
+			sum += std::sqrt(value);
+		}
+
+		volatile float result = sum;
+		(void)result;
+	}
+
+	/// <returns>
+	/// The render's time relative to the calibration workload's. Each is the fastest of a few runs, as anything
+	/// else on the machine only ever makes a run slower, taken in turns so that both see the machine alike.
+	/// </returns>
+	template <typename Function>
+	float RelativeTime(Function&& render)
+	{
+		float calibration = 0;
+		float fastest = 0;
+		for (int run = 0; run < TimingRuns; ++run)
+		{
+			float calibrationRun = Milliseconds(CalibrationWorkload);
+			float renderRun = Milliseconds(render);
+			calibration = run == 0 ? calibrationRun : std::min(calibration, calibrationRun);
+			fastest = run == 0 ? renderRun : std::min(fastest, renderRun);
+		}
+
+		return fastest / calibration;
+	}
+
+	std::map<std::string, float> ReadBaseline()
+	{
+		std::ifstream file(Options.BaselinePath);
+		std::map<std::string, float> baseline;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#') { continue; }
+
+			std::istringstream entry(line);
+			std::string name;
+			float relativeTime;
+			if (entry >> name >> relativeTime) { baseline[name] = relativeTime; }
+		}
+
+		return baseline;
+	}
+
+	void WriteBaseline(const std::map<std::string, float>& baseline)
+	{
+		std::ofstream file(Options.BaselinePath);
+		file << "# Each reference scene's render time at " << TimingSize << "x" << TimingSize << " on one thread, as a "
+			"multiple of the calibration\n# workload's time. Recorded from an optimised build by "
+			"RayTracer_Regression --update-baseline.\n";
+		for (const auto& [name, relativeTime] : baseline) { file << name << ' ' << relativeTime << '\n'; }
+	}
+
+	TEST(RenderRegressionTest, MatchesGoldenImages)
+	{
+		for (const ReferenceScenes::Entry& entry : ReferenceScenes::All())
+		{
+			SCOPED_TRACE(entry.Name);
+			Scene scene = entry.Build(GoldenSize, GoldenSize);
+			Canvas image = scene.Camera_.Render(scene.World_);
+
+			std::string path = Options.GoldenDirectory + "/" + entry.Name + ".ppm";
+			if (Options.UpdateGolden)
+			{
+				image.WritePPM(path);
+				continue;
+			}
+
+			Canvas golden = Canvas::ReadPPM(path);
+			EXPECT_GE(Canvas::PSNR(image, golden), Options.MinPSNR) << "Render differs from " << path;
+		}
+	}
+
+	TEST(RenderRegressionTest, NoSlowerThanBaseline)
+	{
+#if !defined(NDEBUG)
+		// The baseline is from an optimised build, which an unoptimised one would be compared to very unevenly.
+		GTEST_SKIP() << "Render times are only compared in optimised builds.";
+#endif
+
+		std::map<std::string, float> baseline = ReadBaseline();
+
+		// One thread, so that times don't depend on how many cores the machine has.
+		ThreadPool pool(1);
+		for (const ReferenceScenes::Entry& entry : ReferenceScenes::All())
+		{
+			SCOPED_TRACE(entry.Name);
+			Scene scene = entry.Build(TimingSize, TimingSize);
+			float relativeTime = RelativeTime([&] { scene.Camera_.Render(scene.World_, pool); });
+
+			if (Options.UpdateBaseline)
+			{
+				baseline[entry.Name] = relativeTime;
+				continue;
+			}
+
+			auto expected = baseline.find(entry.Name);
+			if (expected == baseline.end())
+			{
+				ADD_FAILURE() << "No baseline for " << entry.Name << " in " << Options.BaselinePath
+					<< ". Run RayTracer_Regression --update-baseline to record one.";
+				continue;
+			}
+
+			float limit = expected->second * (1 + Options.MaxSlowdown / 100);
+			EXPECT_LE(relativeTime, limit) << entry.Name << " took " << relativeTime << " times the calibration "
+				"workload against a baseline of " << expected->second;
+		}
+
+		if (Options.UpdateBaseline) { WriteBaseline(baseline); }
+	}
+}
+
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+
+	// RayTracer_Regression [--golden <directory>] [--baseline <file>] [--max-slowdown <percent>]
+	//                      [--min-psnr <decibels>] [--update] [--update-golden] [--update-baseline]
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+	RayTracer::RegressionOptions& options = RayTracer::Options;
+	for (size_t i = 0; i < arguments.size(); ++i)
+	{
+		bool hasValue = i + 1 < arguments.size();
+		if (arguments[i] == "--golden" && hasValue) { options.GoldenDirectory = arguments[++i]; }
+		else if (arguments[i] == "--baseline" && hasValue) { options.BaselinePath = arguments[++i]; }
+		else if (arguments[i] == "--max-slowdown" && hasValue) { options.MaxSlowdown = std::stof(arguments[++i]); }
+		else if (arguments[i] == "--min-psnr" && hasValue) { options.MinPSNR = std::stof(arguments[++i]); }
+		else if (arguments[i] == "--update") { options.UpdateGolden = options.UpdateBaseline = true; }
+		else if (arguments[i] == "--update-golden") { options.UpdateGolden = true; }
+		else if (arguments[i] == "--update-baseline") { options.UpdateBaseline = true; }
+		else
+		{
+			std::cerr << "Unknown argument " << arguments[i] << std::endl;
+			return 1;
+		}
+	}
+
+	return RUN_ALL_TESTS();
+}
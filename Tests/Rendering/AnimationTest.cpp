@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include <numbers>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(AnimationTest, FramesMatchIndependentRenders)
+	{
+		World world = World::ExampleWorld();
+		world.Add<Plane>(Matrix<4>::Translation(0, -1, 0));
+		Shape& moving = *world.Objects[1];
+
+		Camera camera{20, 15, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		auto path = [](float time) { return Matrix<4>::Scaling(0.5, 0.5, 0.5).Translated(time, 0, -2); };
+
+		Animation animation(world, camera);
+		animation.FramesPerSecond = 2;
+		animation.Animate(moving, path);
+
+		std::vector<int> frames;
+		animation.Render(0, 3, [&](int frame, const Canvas& image)
+		{
+			frames.push_back(frame);
+
+			// An independent world without the acceleration structure, moved by hand.
+			World expectedWorld = World::ExampleWorld();
+			expectedWorld.Add<Plane>(Matrix<4>::Translation(0, -1, 0));
+			expectedWorld.Objects[1]->SetTransform(path(frame / 2.f));
+			ASSERT_EQ(image.GetPixels(), camera.Render(expectedWorld).GetPixels());
+		});
+
+		ASSERT_EQ(frames, (std::vector<int>{0, 1, 2, 3}));
+		ASSERT_EQ(moving.GetTransform(), path(1.5));
+		ASSERT_TRUE(world.Acceleration.IsBuiltFor(world.Objects));
+	}
+
+	TEST(AnimationTest, AnimatedCamera)
+	{
+		World world = World::ExampleWorld();
+		Camera camera{10, 10, std::numbers::pi / 2};
+
+		Animation animation(world, camera);
+		animation.AnimateCamera([](float time)
+		{
+			return Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5 - time), Tuple::Point(0, 0, 0),
+			                                Tuple::Vector(0, 1, 0));
+		});
+		animation.SetTime(3);
+
+		ASSERT_EQ(camera.Transform, Matrix<4>::ViewTransform(Tuple::Point(0, 0, -8), Tuple::Point(0, 0, 0),
+		                                                     Tuple::Vector(0, 1, 0)));
+	}
+}
@@ -1,6 +1,11 @@
 
 #include "gtest/gtest.h"
+#include <cmath>
+#include <mutex>
+#include <limits>
 #include <numbers>
+#include <sstream>
+#include <vector>
 import RayTracer;
 
 namespace RayTracer
@@ -52,6 +57,31 @@ namespace RayTracer
 		ASSERT_EQ(ray.Direction, Tuple::Vector(sqrtf(2) / 2.f, 0, -sqrtf(2) / 2.f));
 	}
 
+	TEST(CameraTest, RaysForRow)
+	{
+		Camera camera{ 201, 101, std::numbers::pi / 2.f };
+		camera.Transform.Translate(0, -2, 5).RotateY(std::numbers::pi / 4.f);
+
+		std::vector<Ray> rays(camera.RenderWidth, Ray{ Tuple::Point(0, 0, 0), Tuple::Vector(0, 0, 0) });
+		camera.RaysForRow(50, 0, rays);
+		for (int x = 0; x < camera.RenderWidth; ++x)
+		{
+			Ray ray = camera.RayForPixel(x, 50);
+			ASSERT_EQ(rays[x].Origin, ray.Origin);
+			ASSERT_EQ(rays[x].Direction, ray.Direction);
+		}
+		ASSERT_EQ(rays[100].Direction, Tuple::Vector(sqrtf(2) / 2.f, 0, -sqrtf(2) / 2.f));
+	}
+
+	TEST(CameraTest, RayAfterTransformChanged)
+	{
+		Camera camera{ 201, 101, std::numbers::pi / 2.f };
+		ASSERT_EQ(camera.RayForPixel(100, 50).Origin, Tuple::Point(0, 0, 0));
+
+		camera.Transform.Translate(0, -2, 5);
+		ASSERT_EQ(camera.RayForPixel(100, 50).Origin, Tuple::Point(0, 2, -5));
+	}
+
 	TEST(CameraTest, Render)
 	{
 		World world = World::ExampleWorld();
@@ -65,4 +95,139 @@ namespace RayTracer
 		Canvas image = camera.Render(world);
 		ASSERT_EQ(image.GetPixel(5, 5), Tuple::Colour(0.38066, 0.47583, 0.2855));
 	}
+
+	TEST(CameraTest, RenderRegion)
+	{
+		World world = World::ExampleWorld();
+
+		Camera camera{11, 11, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		Canvas full = camera.Render(world);
+		Canvas crop = camera.Render(world, {4, 3, 5, 4});
+		ASSERT_EQ(crop.GetWidth(), 5);
+		ASSERT_EQ(crop.GetHeight(), 4);
+		ASSERT_EQ(crop.GetPixel(1, 2), full.GetPixel(5, 5));
+		ASSERT_EQ(crop.GetPixel(4, 3), full.GetPixel(8, 6));
+	}
+
+	TEST(CameraTest, RenderRegionIntoTarget)
+	{
+		World world = World::ExampleWorld();
+
+		Camera camera{11, 11, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		Canvas full = camera.Render(world);
+
+		// Pixels outside the region are left as they were.
+		Canvas target(11, 11);
+		target.SetPixel(0, 0, Colour::Red);
+		camera.Render(world, {5, 5, 2, 2}, target);
+		ASSERT_EQ(target.GetPixel(0, 0), Colour::Red);
+		ASSERT_EQ(target.GetPixel(5, 5), full.GetPixel(5, 5));
+		ASSERT_EQ(target.GetPixel(6, 6), full.GetPixel(6, 6));
+		ASSERT_EQ(target.GetPixel(7, 7), Colour::Black);
+
+		// Rendering every tile into a shared canvas gives the full image.
+		Canvas tiled(11, 11);
+		for (const Region& tile : camera.GetRegion().Tiles(4)) { camera.Render(world, tile, tiled); }
+		ASSERT_EQ(tiled.GetPixels(), full.GetPixels());
+
+		// Or at an offset.
+		Canvas offset(4, 4);
+		camera.Render(world, {5, 5, 2, 2}, offset, 2, 1);
+		ASSERT_EQ(offset.GetPixel(2, 1), full.GetPixel(5, 5));
+		ASSERT_EQ(offset.GetPixel(3, 2), full.GetPixel(6, 6));
+	}
+
+	TEST(CameraTest, RenderBatch)
+	{
+		World world = World::ExampleWorld();
+
+		// A turntable of differently sized views.
+		std::vector<Camera> cameras;
+		for (int i = 0; i < 3; ++i)
+		{
+			float angle = i * std::numbers::pi / 3;
+			cameras.emplace_back(20 + 10 * i, 15, std::numbers::pi / 2,
+			                     Matrix<4>::ViewTransform(Tuple::Point(5 * std::sin(angle), 0, -5 * std::cos(angle)),
+			                                              Tuple::Point(0, 0, 0), Tuple::Vector(0, 1, 0)));
+		}
+
+		std::vector<size_t> finished;
+		std::mutex mutex;
+		ThreadPool pool(2);
+		std::vector<Canvas> images = Camera::RenderBatch(world, cameras, [&](size_t camera, const Canvas& image)
+		{
+			std::lock_guard lock(mutex);
+			ASSERT_EQ(image.GetWidth(), cameras[camera].RenderWidth);
+			finished.push_back(camera);
+		}, pool);
+
+		ASSERT_EQ(images.size(), 3);
+		ASSERT_EQ(finished.size(), 3);
+		for (size_t i = 0; i < cameras.size(); ++i)
+		{
+			ASSERT_EQ(images[i].GetPixels(), cameras[i].Render(world).GetPixels());
+		}
+	}
+
+	TEST(CameraTest, RenderStreaming)
+	{
+		World world = World::ExampleWorld();
+		Camera camera{23, 17, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+		Canvas expected = camera.Render(world);
+
+		std::stringstream ppm;
+		camera.RenderStreaming(world, ppm, StreamFormat::BinaryPPM, 5);
+		ASSERT_EQ(Canvas::PSNR(Canvas::ReadPPM(ppm), expected), std::numeric_limits<float>::infinity());
+
+		std::stringstream raw;
+		camera.RenderStreaming(world, raw, StreamFormat::RawFloat, 4);
+		std::vector<float> values(23 * 17 * 3);
+		raw.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(float));
+		ASSERT_EQ(raw.gcount(), values.size() * sizeof(float));
+		for (size_t i = 0; i < expected.GetPixels().size(); ++i)
+		{
+			ASSERT_EQ(Tuple::Colour(values[3 * i], values[3 * i + 1], values[3 * i + 2]), expected.GetPixels()[i]);
+		}
+	}
+
+	TEST(CameraTest, RenderStreamingHoldsOneBand)
+	{
+		World world = World::ExampleWorld();
+		Camera camera{64, 256, std::numbers::pi / 2};
+
+		MemoryTracker::Enable();
+		MemoryTracker::ResetPeaks();
+		size_t framebuffers = MemoryTracker::GetCurrentBytes(MemoryCategory::Framebuffers);
+
+		std::stringstream output;
+		camera.RenderStreaming(world, output, StreamFormat::BinaryPPM, 8);
+		MemoryTracker::Disable();
+
+		ASSERT_EQ(MemoryTracker::GetPeakBytes(MemoryCategory::Framebuffers) - framebuffers, 64 * 8 * sizeof(Tuple));
+	}
+
+	TEST(CameraTest, RenderTiledLayouts)
+	{
+		World world = World::ExampleWorld();
+		Camera camera{37, 21, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 1, 0),
+		                                            Tuple::Vector(0, 1, 0));
+		Canvas expected = camera.Render(world);
+
+		for (CanvasLayout layout : {CanvasLayout::Tiled, CanvasLayout::Morton})
+		{
+			camera.Layout = layout;
+			Canvas image = camera.Render(world);
+			ASSERT_EQ(image.GetLayout(), layout);
+			ASSERT_EQ(image.ToLinear(), expected.GetPixels());
+		}
+	}
 }
@@ -1,5 +1,10 @@
 ﻿import RayTracer;
 #include "gtest/gtest.h"
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 
 namespace RayTracer
 {
@@ -22,4 +27,132 @@ namespace RayTracer
 		canvas.SetPixel(2, 3, red);
 		ASSERT_EQ(canvas.GetPixel(2, 3), red);
 	}
+
+	TEST(CanvasTest, RegionTiles)
+	{
+		Region region{2, 1, 10, 5};
+		std::vector<Region> tiles = region.Tiles(4);
+		ASSERT_EQ(tiles.size(), 6);
+		ASSERT_EQ(tiles[0], (Region{2, 1, 4, 4}));
+		ASSERT_EQ(tiles[2], (Region{10, 1, 2, 4}));
+		ASSERT_EQ(tiles[5], (Region{10, 5, 2, 1}));
+
+		// Would never get past the first tile.
+		ASSERT_THROW(region.Tiles(0), std::runtime_error);
+		ASSERT_THROW(region.Tiles(-4), std::runtime_error);
+	}
+
+	TEST(CanvasTest, PPMRoundTrip)
+	{
+		Canvas canvas(3, 2);
+		canvas.SetPixel(0, 0, Tuple::Colour(1.5f, 0, -0.5f));
+		canvas.SetPixel(1, 0, Tuple::Colour(0, 0.5f, 0));
+		canvas.SetPixel(2, 1, Tuple::Colour(0, 0, 1));
+
+		std::stringstream stream;
+		canvas.WritePPM(stream);
+		Canvas read = Canvas::ReadPPM(stream);
+
+		ASSERT_EQ(read.GetWidth(), 3);
+		ASSERT_EQ(read.GetHeight(), 2);
+		ASSERT_EQ(read.GetPixel(0, 0), Tuple::Colour(1, 0, 0));
+		ASSERT_EQ(read.GetPixel(2, 1), Tuple::Colour(0, 0, 1));
+		ASSERT_EQ(Canvas::PSNR(canvas, read), std::numeric_limits<float>::infinity());
+
+		std::stringstream notAnImage("P5 1 1 255");
+		ASSERT_THROW(Canvas::ReadPPM(notAnImage), std::runtime_error);
+	}
+
+	TEST(CanvasTest, PSNR)
+	{
+		Canvas black(10, 10);
+		Canvas white(10, 10);
+		for (int y = 0; y < 10; ++y) for (int x = 0; x < 10; ++x) { white.SetPixel(x, y, Colour::White); }
+		ASSERT_NEAR(Canvas::PSNR(black, white), 0, 1e-4);
+
+		// A single channel of one pixel off by one.
+		Canvas nearlyBlack(10, 10);
+		nearlyBlack.SetPixel(0, 0, Tuple::Colour(1 / 255.0f, 0, 0));
+		ASSERT_NEAR(Canvas::PSNR(black, nearlyBlack), 10 * std::log10(255.0 * 255.0 * 300), 1e-3);
+
+		ASSERT_EQ(Canvas::PSNR(black, Canvas(5, 5)), 0);
+	}
+
+	TEST(CanvasTest, LayoutsHoldTheSameImage)
+	{
+		// Not a whole number of blocks either way, so the padded edge blocks are exercised.
+		Canvas linear(19, 11);
+		for (int y = 0; y < 11; ++y) for (int x = 0; x < 19; ++x)
+		{
+			linear.SetPixel(x, y, Tuple::Colour(x / 19.0f, y / 11.0f, 0.5f));
+		}
+
+		for (CanvasLayout layout : {CanvasLayout::Tiled, CanvasLayout::Morton})
+		{
+			Canvas canvas(19, 11, layout);
+			ASSERT_EQ(canvas.GetLayout(), layout);
+			for (int y = 0; y < 11; ++y) for (int x = 0; x < 19; ++x) { canvas.SetPixel(x, y, linear.GetPixel(x, y)); }
+
+			ASSERT_EQ(canvas.ToLinear(), linear.GetPixels());
+			ASSERT_EQ(linear.WithLayout(layout).ToLinear(), linear.GetPixels());
+			ASSERT_EQ(canvas.WithLayout(CanvasLayout::Linear).GetPixels(), linear.GetPixels());
+			ASSERT_EQ(Canvas::PSNR(canvas, linear), std::numeric_limits<float>::infinity());
+
+			std::stringstream written, expected;
+			canvas.WritePPM(written);
+			linear.WritePPM(expected);
+			ASSERT_EQ(written.str(), expected.str());
+
+			written.str("");
+			expected.str("");
+			canvas.WriteRows(written, StreamFormat::RawFloat, 11);
+			linear.WriteRows(expected, StreamFormat::RawFloat, 11);
+			ASSERT_EQ(written.str(), expected.str());
+		}
+	}
+
+	TEST(CanvasTest, LayoutAccessMatchesPixels)
+	{
+		for (CanvasLayout layout : {CanvasLayout::Linear, CanvasLayout::Tiled, CanvasLayout::Morton})
+		{
+			Canvas canvas(19, 11, layout), expected(19, 11, layout);
+			canvas.WithLayoutAccess([&](auto pixels)
+			{
+				for (int y = 0; y < 11; ++y) for (int x = 0; x < 19; ++x)
+				{
+					pixels.SetPixel(x, y, Tuple::Colour(x / 19.0f, y / 11.0f, 0.5f));
+					expected.SetPixel(x, y, Tuple::Colour(x / 19.0f, y / 11.0f, 0.5f));
+					ASSERT_EQ(pixels.GetPixel(x, y), expected.GetPixel(x, y));
+				}
+			});
+
+			ASSERT_EQ(canvas.ToLinear(), expected.ToLinear());
+		}
+	}
+
+	TEST(CanvasTest, RowAndTileIteration)
+	{
+		Canvas canvas(12, 10, CanvasLayout::Morton);
+		for (Tuple& pixel : canvas.Row(3)) { pixel = Colour::White; }
+
+		int visited = 0;
+		for (auto pixel = canvas.Tile({2, 2, 4, 3}).begin(); pixel != canvas.Tile({2, 2, 4, 3}).end(); ++pixel)
+		{
+			ASSERT_EQ(*pixel, pixel.GetY() == 3 ? Colour::White : Colour::Black);
+			ASSERT_EQ(pixel.GetX(), 2 + visited % 4);
+			ASSERT_EQ(pixel.GetY(), 2 + visited / 4);
+			++visited;
+		}
+		ASSERT_EQ(visited, 12);
+
+		const Canvas& constant = canvas;
+		ASSERT_EQ(std::ranges::distance(constant.Row(9)), 12);
+		ASSERT_EQ(std::ranges::distance(constant.Tile({3, 4, 0, 2})), 0);
+
+		// Blocks cover the image, in the order the tiled layouts store them.
+		std::vector<Region> blocks = canvas.GetBlocks();
+		ASSERT_EQ(blocks.size(), 4);
+		ASSERT_EQ(blocks[1], (Region{8, 0, 4, 8}));
+		ASSERT_EQ(canvas.GetBlocks(2).size(), 1);
+	}
 }
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <filesystem>
+#include <numbers>
+#include <string>
+
+import RayTracer;
+
+#if !defined(_WIN32)
+namespace RayTracer
+{
+	std::string CheckpointPath(const char* name)
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+		std::filesystem::remove(path);
+		return path.string();
+	}
+
+	Camera CheckpointCamera()
+	{
+		return {40, 30, std::numbers::pi / 2, Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                                               Tuple::Vector(0, 1, 0))};
+	}
+
+	TEST(CheckpointTest, ResumeSkipsFinishedTiles)
+	{
+		std::string path = CheckpointPath("RayTracerCheckpointTest.checkpoint");
+		World world = World::ExampleWorld();
+		Camera camera = CheckpointCamera();
+		Canvas expected = camera.Render(world);
+
+		{
+			Checkpoint checkpoint(path, 40, 30, 16, 1);
+			ASSERT_EQ(checkpoint.GetTiles().size(), 6);
+			ASSERT_EQ(checkpoint.GetDoneCount(), 0);
+			ASSERT_EQ(camera.Render(world, checkpoint).GetPixels(), expected.GetPixels());
+			ASSERT_TRUE(checkpoint.IsComplete());
+		}
+
+		// Everything comes from the checkpoint, so changing the world changes nothing.
+		World changed = World::ExampleWorld();
+		changed.SetMaterial(*changed.Objects[0], Material{Colour::Red});
+		{
+			Checkpoint checkpoint(path, 40, 30, 16, 1);
+			ASSERT_TRUE(checkpoint.IsComplete());
+			ASSERT_EQ(camera.Render(changed, checkpoint).GetPixels(), expected.GetPixels());
+		}
+
+		// A checkpoint for another scene starts again.
+		{
+			Checkpoint checkpoint(path, 40, 30, 16, 2);
+			ASSERT_EQ(checkpoint.GetDoneCount(), 0);
+			ASSERT_EQ(camera.Render(changed, checkpoint).GetPixels(), camera.Render(changed).GetPixels());
+		}
+	}
+
+	TEST(CheckpointTest, OnlyCommittedTilesAreDone)
+	{
+		std::string path = CheckpointPath("RayTracerCheckpointCommitTest.checkpoint");
+		World world = World::ExampleWorld();
+		Camera camera = CheckpointCamera();
+		Canvas expected = camera.Render(world);
+
+		Checkpoint checkpoint(path, 40, 30, 16);
+		checkpoint.Interval = std::chrono::hours(1);
+		checkpoint.SetTile(0, expected);
+		checkpoint.Commit();
+		checkpoint.SetTile(1, expected);
+
+		// Seen as if the render had died now, through a second mapping of the file.
+		Checkpoint resumed(path, 40, 30, 16);
+		ASSERT_EQ(resumed.GetDoneCount(), 1);
+		ASSERT_TRUE(resumed.IsTileDone(0));
+		ASSERT_FALSE(resumed.IsTileDone(1));
+
+		Canvas image(40, 30);
+		resumed.Restore(image);
+		ASSERT_EQ(image.GetPixel(15, 15), expected.GetPixel(15, 15));
+		ASSERT_EQ(image.GetPixel(16, 0), Colour::Black);
+
+		ASSERT_EQ(camera.Render(world, resumed).GetPixels(), expected.GetPixels());
+	}
+
+	TEST(CheckpointTest, CommitsWhileOtherTilesAreSet)
+	{
+		std::string path = CheckpointPath("RayTracerCheckpointConcurrentTest.checkpoint");
+		World world = World::ExampleWorld();
+		Camera camera = CheckpointCamera();
+		Canvas expected = camera.Render(world);
+
+		// Every tile commits, each from its own thread, so commits overlap with each other and with setting tiles.
+		Checkpoint checkpoint(path, 40, 30, 16);
+		checkpoint.Interval = std::chrono::milliseconds(0);
+		ThreadPool threadPool(4);
+		threadPool.ParallelFor(checkpoint.GetTiles().size(), [&](size_t tile) { checkpoint.SetTile(tile, expected); });
+		ASSERT_TRUE(checkpoint.IsComplete());
+
+		Checkpoint resumed(path, 40, 30, 16);
+		ASSERT_TRUE(resumed.IsComplete());
+	}
+
+	TEST(CheckpointTest, SceneKeyIsFNV1a)
+	{
+		// The same on every platform, so a checkpoint can be resumed by another build.
+		ASSERT_EQ(Checkpoint::SceneKey(""), 0xcbf29ce484222325);
+		ASSERT_EQ(Checkpoint::SceneKey("a"), 0xaf63dc4c8601ec8c);
+		ASSERT_NE(Checkpoint::SceneKey("sphere"), Checkpoint::SceneKey("plane"));
+	}
+}
+#endif
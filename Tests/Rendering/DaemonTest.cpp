@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+import RayTracer;
+import RayTracer.ReferenceScenes;
+
+#if !defined(_WIN32)
+namespace RayTracer
+{
+	TEST(DaemonTest, RendersResidentScenes)
+	{
+		std::filesystem::path directory = std::filesystem::temp_directory_path();
+		std::string address = Socket::UnixPrefix + (directory / "RayTracerDaemonTest.sock").string();
+		std::string scenePath = (directory / "RayTracerDaemonTest.scene").string();
+		std::string imagePath = (directory / "RayTracerDaemonTest.ppm").string();
+
+		Scene scene = ReferenceScenes::Mirrors(32, 24);
+		{
+			std::ofstream file(scenePath);
+			scene.Write(file);
+		}
+
+		RenderDaemon daemon(address);
+		std::thread server([&] { daemon.Run(); });
+
+		ASSERT_EQ(RenderDaemon::Request(address, "render mirrors " + imagePath + " 32 24"), "error no scene mirrors");
+		ASSERT_EQ(RenderDaemon::Request(address, "load mirrors " + scenePath), "ok");
+
+		// Renders with the scene's own camera, then again from somewhere else. Resident scenes have their
+		// acceleration structure built, which can change the odd pixel by rounding.
+		ASSERT_TRUE(RenderDaemon::Request(address, "render mirrors " + imagePath + " 32 24").starts_with("ok "));
+		ASSERT_GT(Canvas::PSNR(Canvas::ReadPPM(imagePath), scene.Camera_.Render(scene.World_)), 40);
+
+		Camera camera(16, 16, std::numbers::pi / 2,
+		              Matrix<4>::ViewTransform(Tuple::Point(0, 0, -3), Tuple::Point(0, 0, 1), Tuple::Vector(0, 1, 0)));
+		std::string render = "render mirrors " + imagePath + " 16 16 " + std::to_string(std::numbers::pi / 2) +
+			" 0 0 -3 0 0 1 0 1 0";
+		ASSERT_TRUE(RenderDaemon::Request(address, render).starts_with("ok "));
+		ASSERT_GT(Canvas::PSNR(Canvas::ReadPPM(imagePath), camera.Render(scene.World_)), 40);
+
+		ASSERT_TRUE(RenderDaemon::Request(address, "render mirrors").starts_with("error "));
+		ASSERT_TRUE(RenderDaemon::Request(address, "explode").starts_with("error "));
+		ASSERT_EQ(RenderDaemon::Request(address, "unload mirrors"), "ok");
+		ASSERT_EQ(RenderDaemon::Request(address, "unload mirrors"), "error no scene mirrors");
+
+		ASSERT_EQ(RenderDaemon::Request(address, "stop"), "ok");
+		server.join();
+	}
+
+	std::string ConcurrentImagePath(const std::filesystem::path& directory, size_t client)
+	{
+		return (directory / ("RayTracerDaemonConcurrentTest" + std::to_string(client) + ".ppm")).string();
+	}
+
+	TEST(DaemonTest, ConcurrentRenders)
+	{
+		std::filesystem::path directory = std::filesystem::temp_directory_path();
+		std::string address = Socket::UnixPrefix + (directory / "RayTracerDaemonConcurrentTest.sock").string();
+		std::string scenePath = (directory / "RayTracerDaemonConcurrentTest.scene").string();
+
+		Scene scene = ReferenceScenes::Example(20, 20);
+		{
+			std::ofstream file(scenePath);
+			scene.Write(file);
+		}
+
+		RenderDaemon daemon(address);
+		std::thread server([&] { daemon.Run(); });
+		ASSERT_EQ(RenderDaemon::Request(address, "load example " + scenePath), "ok");
+
+		std::vector<std::thread> clients;
+		std::vector<std::string> answers(4);
+		for (size_t i = 0; i < answers.size(); ++i)
+		{
+			clients.emplace_back([&, i]
+			{
+				answers[i] = RenderDaemon::Request(address, "render example " + ConcurrentImagePath(directory, i) +
+					" 20 20");
+			});
+		}
+		for (std::thread& client : clients) { client.join(); }
+
+		RenderDaemon::Request(address, "stop");
+		server.join();
+
+		// Every render of the same scene comes out the same, however they overlap.
+		std::vector<Canvas> images;
+		for (size_t i = 0; i < answers.size(); ++i)
+		{
+			ASSERT_TRUE(answers[i].starts_with("ok ")) << answers[i];
+			images.push_back(Canvas::ReadPPM(ConcurrentImagePath(directory, i)));
+			ASSERT_EQ(Canvas::PSNR(images[i], images[0]), std::numeric_limits<float>::infinity());
+		}
+		ASSERT_GT(Canvas::PSNR(images[0], scene.Camera_.Render(scene.World_)), 40);
+	}
+
+	TEST(DaemonTest, SurvivesBadRequests)
+	{
+		ASSERT_THROW(RenderDaemon(":0"), std::runtime_error);
+
+		std::string address = Socket::UnixPrefix +
+			(std::filesystem::temp_directory_path() / "RayTracerDaemonBadTest.sock").string();
+		RenderDaemon daemon(address);
+		std::thread server([&] { daemon.Run(); });
+
+		// A length far too long to allocate, then one just over the limit, are dropped without an answer.
+		for (unsigned long long size : {std::numeric_limits<unsigned long long>::max(),
+		                                RenderDaemon::MaxRequestSize + 1})
+		{
+			Socket client = Socket::Connect(address);
+			client.SendValue(size);
+			std::string answer;
+			ASSERT_FALSE(client.ReceiveString(answer));
+		}
+
+		ASSERT_EQ(RenderDaemon::Request(address, "stop"), "ok");
+		server.join();
+	}
+}
+#endif
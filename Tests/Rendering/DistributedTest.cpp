@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <numbers>
+#include <thread>
+
+import RayTracer;
+
+#if !defined(_WIN32)
+namespace RayTracer
+{
+	namespace
+	{
+		Scene DistributedScene()
+		{
+			World world = World::ExampleWorld();
+			Shape* plane = &world.Add<Plane>();
+			world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+			plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
+
+			Camera camera{40, 30, std::numbers::pi / 2};
+			camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0, 0),
+			                                            Tuple::Vector(0, 1, 0));
+			return {world, camera};
+		}
+
+		std::string SocketAddress(const char* name)
+		{
+			return Socket::UnixPrefix + (std::filesystem::temp_directory_path() / name).string();
+		}
+	}
+
+	TEST(DistributedTest, MatchesLocalRender)
+	{
+		Scene scene = DistributedScene();
+		std::string address = SocketAddress("RayTracerDistributedTest.sock");
+
+		Coordinator coordinator(address);
+		std::thread worker1(Worker::Run, address);
+		std::thread worker2(Worker::Run, address);
+
+		Canvas image = coordinator.Render(scene, 8);
+		worker1.join();
+		worker2.join();
+
+		ASSERT_EQ(image.GetPixels(), scene.Camera_.Render(scene.World_).GetPixels());
+	}
+
+	TEST(DistributedTest, DeadWorkerTileReassigned)
+	{
+		Scene scene = DistributedScene();
+		std::string address = SocketAddress("RayTracerDeadWorkerTest.sock");
+
+		Coordinator coordinator(address);
+
+		// Takes a tile and disconnects without ever returning it.
+		std::thread deadWorker([&address]
+		{
+			Socket socket = Socket::Connect(address);
+			std::string sceneText;
+			socket.ReceiveString(sceneText);
+			int tile[4];
+			socket.ReceiveValue(tile);
+		});
+
+		// Only joins once the dead worker is gone, so the dead worker is guaranteed to have taken a tile.
+		std::thread worker([&]
+		{
+			deadWorker.join();
+			Worker::Run(address);
+		});
+
+		Canvas image = coordinator.Render(scene, 8);
+		worker.join();
+
+		ASSERT_EQ(image.GetPixels(), scene.Camera_.Render(scene.World_).GetPixels());
+	}
+
+	TEST(DistributedTest, HungWorkerDropped)
+	{
+		Scene scene = DistributedScene();
+		std::string address = SocketAddress("RayTracerHungWorkerTest.sock");
+
+		Coordinator coordinator(address);
+		coordinator.TileTimeout = std::chrono::milliseconds(100);
+
+		// Takes the only tile and stays connected without returning it, until the coordinator gives up on it.
+		std::thread hungWorker([&address]
+		{
+			Socket socket = Socket::Connect(address);
+			std::string sceneText;
+			socket.ReceiveString(sceneText);
+			int tile[4];
+			socket.ReceiveValue(tile);
+			socket.ReceiveValue(tile);
+		});
+
+		std::thread worker([&]
+		{
+			hungWorker.join();
+			Worker::Run(address);
+		});
+
+		Canvas image = coordinator.Render(scene, 64);
+		worker.join();
+
+		ASSERT_EQ(image.GetPixels(), scene.Camera_.Render(scene.World_).GetPixels());
+	}
+
+	TEST(DistributedTest, WorkerStoppingPartWayThroughTileDropped)
+	{
+		Scene scene = DistributedScene();
+		std::string address = SocketAddress("RayTracerPartialTileTest.sock");
+
+		Coordinator coordinator(address);
+		coordinator.TileTimeout = std::chrono::milliseconds(100);
+
+		// Sends back the start of the only tile and stays connected without the rest, until the coordinator gives up.
+		std::thread stalledWorker([&address]
+		{
+			Socket socket = Socket::Connect(address);
+			std::string sceneText;
+			socket.ReceiveString(sceneText);
+			int tile[4];
+			socket.ReceiveValue(tile);
+			socket.SendValue(tile);
+			float pixels[6] = {};
+			socket.SendValue(pixels);
+			socket.ReceiveValue(tile);
+		});
+
+		std::thread worker([&]
+		{
+			stalledWorker.join();
+			Worker::Run(address);
+		});
+
+		Canvas image = coordinator.Render(scene, 64);
+		worker.join();
+
+		ASSERT_EQ(image.GetPixels(), scene.Camera_.Render(scene.World_).GetPixels());
+	}
+
+	TEST(DistributedTest, NoWorkers)
+	{
+		Coordinator coordinator(SocketAddress("RayTracerNoWorkersTest.sock"));
+		coordinator.WorkerTimeout = std::chrono::milliseconds(0);
+		ASSERT_THROW(coordinator.Render(DistributedScene()), std::runtime_error);
+	}
+}
+#endif
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include <numbers>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	namespace
+	{
+		Camera GBufferCamera()
+		{
+			Camera camera{16, 12, std::numbers::pi / 2};
+			camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0, 0),
+			                                            Tuple::Vector(0, 1, 0));
+			return camera;
+		}
+	}
+
+	TEST(GBufferTest, RenderKeepsPrimaryHits)
+	{
+		World world = World::ExampleWorld();
+		Camera camera = GBufferCamera();
+
+		GBuffer gBuffer;
+		Canvas image = camera.Render(world, gBuffer);
+
+		ASSERT_EQ(gBuffer.GetWidth(), 16);
+		ASSERT_EQ(gBuffer.GetHeight(), 12);
+		ASSERT_EQ(image.GetPixels(), camera.Render(world).GetPixels());
+
+		const std::optional<Shape::Computation>& hit = gBuffer.GetHit(8, 6);
+		ASSERT_TRUE(hit);
+		ASSERT_EQ(hit->Object, world.Objects[0]);
+		ASSERT_FALSE(gBuffer.GetHit(0, 0));
+	}
+
+	TEST(GBufferTest, RelightAfterMaterialAndLightChange)
+	{
+		World world = World::ExampleWorld();
+		world.Add<Plane>(Matrix<4>::Translation(0, -1, 0));
+		Camera camera = GBufferCamera();
+
+		GBuffer gBuffer;
+		camera.Render(world, gBuffer);
+
+		Material red = world.GetMaterial(*world.Objects[0]);
+		red.Colour = Colour::Red;
+		world.SetMaterial(*world.Objects[0], red);
+		CheckerPattern* checkers = world.Make<CheckerPattern>(Colour::White, Colour::Black);
+		world.SetMaterial(*world.Objects[2], Material{.Reflectiveness = 0.5f, .Pattern_ = checkers});
+		world.Light = PointLight{Tuple::Point(5, 10, -10), Tuple::Colour(1, 0.9, 0.8)};
+
+		ASSERT_EQ(camera.Relight(world, gBuffer).GetPixels(), camera.Render(world).GetPixels());
+	}
+}
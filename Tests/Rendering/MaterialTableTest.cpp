@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include <memory>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(MaterialTableTest, StartsWithDefaultMaterial)
+	{
+		MaterialTable table;
+		ASSERT_EQ(table.GetSize(), 1);
+		ASSERT_TRUE(table.Contains(MaterialTable::DefaultIndex, Material{}));
+	}
+
+	TEST(MaterialTableTest, IdenticalMaterialsShareEntry)
+	{
+		MaterialTable table;
+		Material material{Tuple::Colour(1, 0.9, 0.9)};
+		material.Specular = 0;
+
+		uint32_t first = table.Add(material);
+		uint32_t second = table.Add(material);
+		ASSERT_EQ(first, second);
+		ASSERT_EQ(table.GetSize(), 2); // Along with the default.
+		ASSERT_TRUE(table.Contains(first, material));
+	}
+
+	TEST(MaterialTableTest, DifferentColoursKeptApart)
+	{
+		// Material's operator== ignores colour, the table mustn't.
+		MaterialTable table;
+		uint32_t red = table.Add(Material{Colour::Red});
+		uint32_t blue = table.Add(Material{Colour::Blue});
+		ASSERT_NE(red, blue);
+		ASSERT_EQ(table[red].Colour, Colour::Red);
+		ASSERT_EQ(table[blue].Colour, Colour::Blue);
+	}
+
+	TEST(MaterialTableTest, DifferentPatternsKeptApart)
+	{
+		MaterialTable table;
+		StripePattern stripes(Colour::White, Colour::Black);
+		StripePattern sameStripes(Colour::White, Colour::Black);
+		Material striped;
+		striped.Pattern_ = &stripes;
+		Material alsoStriped;
+		alsoStriped.Pattern_ = &sameStripes;
+
+		ASSERT_NE(table.Add(striped), table.Add(alsoStriped));
+		ASSERT_NE(table.Add(striped), MaterialTable::DefaultIndex);
+	}
+
+	TEST(MaterialTableTest, WorldSharesIdenticalMaterials)
+	{
+		World world = World::ExampleWorld();
+		Shape& sphere = world.Add<Sphere>();
+		world.SetMaterial(sphere, world.GetMaterial(*world.Objects[0]));
+
+		ASSERT_EQ(world.Materials.GetSize(), 2);
+		ASSERT_EQ(world.Objects[0]->GetMaterialIndex(), sphere.GetMaterialIndex());
+		ASSERT_NE(world.Objects[0]->GetMaterialIndex(), world.Objects[1]->GetMaterialIndex());
+	}
+
+	TEST(MaterialTableTest, WorldMaterialReplaced)
+	{
+		World world = World::ExampleWorld();
+		Material before = world.GetMaterial(*world.Objects[0]);
+
+		world.SetMaterial(*world.Objects[1], Material{.Ambient = 1});
+		ASSERT_EQ(world.GetMaterial(*world.Objects[1]).Ambient, 1);
+		ASSERT_TRUE(MaterialTable::IsIdentical(world.GetMaterial(*world.Objects[0]), before));
+	}
+
+	TEST(MaterialTableTest, WorldCopiesKeepMaterials)
+	{
+		World world = World::ExampleWorld();
+		World copy = world;
+		copy.SetMaterial(copy.Add<Sphere>(), Material{Colour::Red});
+
+		// The shared objects' indices are into both tables alike.
+		for (Shape* object : world.Objects)
+		{
+			ASSERT_TRUE(MaterialTable::IsIdentical(copy.GetMaterial(*object), world.GetMaterial(*object)));
+		}
+		ASSERT_EQ(copy.GetMaterial(*copy.Objects.back()).Colour, Colour::Red);
+	}
+}
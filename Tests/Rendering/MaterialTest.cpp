@@ -120,8 +120,9 @@ namespace RayTracer
 
 	TEST(MaterialTest, LightingWithPattern)
 	{
+		StripePattern stripes(Colour::White, Colour::Black);
 		Material material;
-		material.Pattern_ = std::make_shared<StripePattern>(Colour::White, Colour::Black);
+		material.Pattern_ = &stripes;
 		material.Ambient = 1;
 		material.Diffuse = 0;
 		material.Specular = 0;
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <numbers>
+#include <thread>
+#include <unistd.h>
+
+import RayTracer;
+import RayTracer.ReferenceScenes;
+
+#if !defined(_WIN32)
+namespace RayTracer
+{
+	/// <summary>
+	/// A sphere that, when intersected in any process but the one that made it, hangs or exits with a status.
+	/// </summary>
+	class FailingChildSphere : public Sphere
+	{
+		pid_t Parent_ = ::getpid();
+
+		int ExitStatus_;
+
+	public:
+		// Hangs rather than exiting when 0.
+		explicit FailingChildSphere(int exitStatus) : ExitStatus_(exitStatus) {}
+
+		std::vector<Intersection> Intersect(const Ray& ray) override
+		{
+			if (::getpid() != Parent_)
+			{
+				if (ExitStatus_ != 0) { ::_exit(ExitStatus_); }
+				std::this_thread::sleep_for(std::chrono::hours(1));
+			}
+
+			return Sphere::Intersect(ray);
+		}
+	};
+
+	TEST(MultiProcessTest, MatchesRender)
+	{
+		Scene scene = ReferenceScenes::Mirrors(45, 35);
+
+		MultiProcessRenderer renderer(3);
+		Canvas image = renderer.Render(scene.Camera_, scene.World_);
+		ASSERT_EQ(image.GetPixels(), scene.Camera_.Render(scene.World_).GetPixels());
+		ASSERT_TRUE(renderer.GetFailures().empty());
+
+		// Without any children the parent renders every tile itself.
+		Canvas alone = MultiProcessRenderer(0).Render(scene.Camera_, scene.World_);
+		ASSERT_EQ(alone.GetPixels(), image.GetPixels());
+	}
+
+	TEST(MultiProcessTest, FailedChildrenAreReported)
+	{
+		Scene scene = ReferenceScenes::Mirrors(20, 20);
+		scene.World_.Add<FailingChildSphere>(3);
+		Canvas expected = scene.Camera_.Render(scene.World_);
+
+		MultiProcessRenderer renderer(2);
+		ASSERT_EQ(renderer.Render(scene.Camera_, scene.World_).GetPixels(), expected.GetPixels());
+		ASSERT_EQ(renderer.GetFailures().size(), 2);
+		for (const ProcessFailure& failure : renderer.GetFailures())
+		{
+			ASSERT_EQ(failure.ExitStatus, 3);
+			ASSERT_FALSE(failure.IsTimedOut);
+			ASSERT_NE(failure.Describe().find("status 3"), std::string::npos);
+		}
+	}
+
+	TEST(MultiProcessTest, HungChildrenAreKilled)
+	{
+		Scene scene = ReferenceScenes::Mirrors(20, 20);
+		scene.World_.Add<FailingChildSphere>(0);
+		Canvas expected = scene.Camera_.Render(scene.World_);
+
+		MultiProcessRenderer renderer(2);
+		renderer.Timeout = std::chrono::milliseconds(100);
+		ASSERT_EQ(renderer.Render(scene.Camera_, scene.World_).GetPixels(), expected.GetPixels());
+		ASSERT_EQ(renderer.GetFailures().size(), 2);
+		for (const ProcessFailure& failure : renderer.GetFailures())
+		{
+			ASSERT_TRUE(failure.IsTimedOut);
+			ASSERT_EQ(failure.Signal, SIGKILL);
+		}
+	}
+}
+#endif
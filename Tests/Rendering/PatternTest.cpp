@@ -47,27 +47,27 @@ namespace RayTracer
 	TEST(PatternTest, StripesWithObjectTransform)
 	{
 		Sphere sphere;
-		sphere.Transform_.Scale(2, 2, 2);
-		sphere.Material_.Pattern_ = std::make_shared<StripePattern>(Colour::White, Colour::Black);
-		ASSERT_EQ(sphere.StripeAt(Tuple::Point(1.5, 0, 0)), Colour::White);
+		sphere.SetTransform(Matrix<4>::Scaling(2, 2, 2));
+		StripePattern pattern(Colour::White, Colour::Black);
+		ASSERT_EQ(sphere.StripeAt(pattern, Tuple::Point(1.5, 0, 0)), Colour::White);
 	}
 
 	TEST(PatternTest, StripesWithPatternTransform)
 	{
 		Sphere sphere;
-		sphere.Material_.Pattern_ = std::make_shared<StripePattern>(Colour::White, Colour::Black);
-		sphere.Material_.Pattern_->Transform.Scale(2, 2, 2);
-		ASSERT_EQ(sphere.StripeAt(Tuple::Point(1.5, 0, 0)), Colour::White);
+		StripePattern pattern(Colour::White, Colour::Black);
+		pattern.SetTransform(Matrix<4>::Scaling(2, 2, 2));
+		ASSERT_EQ(sphere.StripeAt(pattern, Tuple::Point(1.5, 0, 0)), Colour::White);
 	}
 
 	TEST(PatternTest, StripesWithObjectAndPatternTransform)
 	{
 		Sphere sphere;
-		sphere.Transform_.Scale(2, 2, 2);
-		sphere.Material_.Pattern_ = std::make_shared<StripePattern>(Colour::White, Colour::Black);
-		sphere.Material_.Pattern_->Transform.Scale(0.5, 0, 0);
+		sphere.SetTransform(Matrix<4>::Scaling(2, 2, 2));
+		StripePattern pattern(Colour::White, Colour::Black);
+		pattern.SetTransform(Matrix<4>::Scaling(0.5, 0, 0));
 
-		ASSERT_EQ(sphere.StripeAt(Tuple::Point(2.5, 0, 0)), Colour::White);
+		ASSERT_EQ(sphere.StripeAt(pattern, Tuple::Point(2.5, 0, 0)), Colour::White);
 	}
 
 	TEST(PatternTest, Gradient)
@@ -0,0 +1,136 @@
+import RayTracer;
+#include "gtest/gtest.h"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace RayTracer
+{
+	// An image filled with a single colour.
+	Canvas FlatCanvas(int width, int height, const Tuple& colour, CanvasLayout layout = CanvasLayout::Linear)
+	{
+		Canvas canvas(width, height, layout);
+		for (int y = 0; y < height; ++y) for (Tuple& pixel : canvas.Row(y)) { pixel = colour; }
+
+		return canvas;
+	}
+
+	TEST(PostProcessTest, DefaultsChangeNothing)
+	{
+		Canvas image(21, 19);
+		for (int y = 0; y < 19; ++y) for (int x = 0; x < 21; ++x) { image.SetPixel(x, y, Tuple::Colour(x, y, -1)); }
+
+		ThreadPool pool(3);
+		ASSERT_EQ(PostProcess::Apply(image, {}, pool).GetPixels(), image.GetPixels());
+	}
+
+	TEST(PostProcessTest, ExposureAndToneMapping)
+	{
+		Canvas image = FlatCanvas(4, 4, Tuple::Colour(0.5f, 1, 100));
+
+		PostProcessSettings settings;
+		settings.Exposure = 1;
+		ASSERT_EQ(PostProcess::Apply(image, settings).GetPixel(1, 2), Tuple::Colour(1, 2, 200));
+
+		settings.Exposure = 0;
+		settings.ToneMap = ToneMapper::Reinhard;
+		ASSERT_EQ(PostProcess::Apply(image, settings).GetPixel(3, 3), Tuple::Colour(1 / 3.0f, 0.5f, 100 / 101.0f));
+
+		// ACES reaches white, and keeps darker colours darker.
+		settings.ToneMap = ToneMapper::ACES;
+		Tuple colour = PostProcess::Apply(image, settings).GetPixel(0, 0);
+		ASSERT_FLOAT_EQ(colour.Z, 1);
+		ASSERT_LT(colour.X, colour.Y);
+		ASSERT_LT(colour.Y, colour.Z);
+	}
+
+	TEST(PostProcessTest, Encoding)
+	{
+		Canvas image = FlatCanvas(3, 2, Tuple::Colour(0.5f, 0.001f, 1));
+
+		PostProcessSettings settings;
+		settings.Transfer = TransferFunction::Gamma;
+		ASSERT_NEAR(PostProcess::Apply(image, settings).GetPixel(0, 0).X, std::pow(0.5f, 1 / 2.2f), 1e-5);
+
+		settings.Transfer = TransferFunction::SRGB;
+		Tuple colour = PostProcess::Apply(image, settings).GetPixel(2, 1);
+		ASSERT_NEAR(colour.X, 0.735357f, 1e-5);
+		ASSERT_NEAR(colour.Y, 0.01292f, 1e-6);
+		ASSERT_NEAR(colour.Z, 1, 1e-5);
+	}
+
+	TEST(PostProcessTest, BloomSpreadsOnlyBrightLight)
+	{
+		Canvas image = FlatCanvas(41, 41, Tuple::Colour(0.5f, 0.5f, 0.5f));
+		image.SetPixel(20, 20, Tuple::Colour(11, 0.5f, 0.5f));
+
+		PostProcessSettings settings;
+		settings.BloomStrength = 0.5f;
+		settings.BloomRadius = 6;
+		Canvas bloomed = PostProcess::Apply(image, settings);
+
+		// Light above the threshold is spread out, adding up to its strength's share of it.
+		float added = 0;
+		for (int y = 0; y < 41; ++y) for (int x = 0; x < 41; ++x)
+		{
+			added += bloomed.GetPixel(x, y).X - image.GetPixel(x, y).X;
+		}
+		ASSERT_NEAR(added, 0.5f * 10, 1e-3);
+		ASSERT_GT(bloomed.GetPixel(23, 20).X, bloomed.GetPixel(25, 20).X);
+		ASSERT_GT(bloomed.GetPixel(25, 20).X, 0.5f);
+		ASSERT_FLOAT_EQ(bloomed.GetPixel(27, 20).X, 0.5f);
+		ASSERT_FLOAT_EQ(bloomed.GetPixel(23, 20).Y, 0.5f);
+	}
+
+	TEST(PostProcessTest, OrderedDither)
+	{
+		Canvas image = FlatCanvas(16, 16, Tuple::Colour(0.25f, 0.25f, 0.25f));
+
+		PostProcessSettings settings;
+		settings.Dither = true;
+		Canvas dithered = PostProcess::Apply(image, settings);
+
+		// Every pixel moves by under half a step of the output, averaging out to nothing over each 8 by 8 square.
+		float total = 0;
+		for (int y = 0; y < 8; ++y) for (int x = 0; x < 8; ++x)
+		{
+			float offset = dithered.GetPixel(x, y).X - 0.25f;
+			ASSERT_LT(std::abs(offset), 0.5f / 255);
+			ASSERT_FLOAT_EQ(dithered.GetPixel(x + 8, y + 8).X, dithered.GetPixel(x, y).X);
+			total += offset;
+		}
+		ASSERT_NEAR(total, 0, 1e-5);
+	}
+
+	TEST(PostProcessTest, SameInEveryLayout)
+	{
+		Canvas image(27, 22);
+		for (int y = 0; y < 22; ++y) for (int x = 0; x < 27; ++x)
+		{
+			image.SetPixel(x, y, Tuple::Colour(x % 5 == 0 ? 4.0f : 0.2f, y / 10.0f, 0.5f));
+		}
+
+		PostProcessSettings settings{0.5f, ToneMapper::ACES, TransferFunction::SRGB, 2.2f, 0.3f, 1, 4, true};
+		Canvas expected = PostProcess::Apply(image, settings);
+		for (CanvasLayout layout : {CanvasLayout::Tiled, CanvasLayout::Morton})
+		{
+			Canvas graded = PostProcess::Apply(image.WithLayout(layout), settings);
+			ASSERT_EQ(graded.GetLayout(), layout);
+			ASSERT_EQ(graded.ToLinear(), expected.GetPixels());
+		}
+	}
+
+	TEST(PostProcessTest, RegradeFromRawFloat)
+	{
+		Canvas image = FlatCanvas(5, 3, Tuple::Colour(2.5f, 0, 1));
+		image.SetPixel(4, 2, Tuple::Colour(-1, 7, 0.25f));
+
+		std::stringstream raw;
+		image.WriteRows(raw, StreamFormat::RawFloat, 3);
+		Canvas read = Canvas::ReadRawFloat(raw, 5, 3);
+		ASSERT_EQ(read.GetPixels(), image.GetPixels());
+
+		std::stringstream truncated(raw.str().substr(0, 20));
+		ASSERT_THROW(Canvas::ReadRawFloat(truncated, 5, 3), std::runtime_error);
+	}
+}
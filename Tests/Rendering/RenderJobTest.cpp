@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <numbers>
+#include <stdexcept>
+#include <thread>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(RenderJobTest, MatchesRender)
+	{
+		World world = World::ExampleWorld();
+		Camera camera{40, 20, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		ThreadPool pool(2);
+		RenderJob job = camera.RenderAsync(world, pool);
+
+		std::atomic<int> tilesDone = 0;
+		job.OnTileDone([&](const Region&) { ++tilesDone; });
+
+		ASSERT_EQ(job.Wait().GetPixels(), camera.Render(world).GetPixels());
+		ASSERT_TRUE(job.IsFinished());
+		ASSERT_FALSE(job.IsCancelled());
+		ASSERT_EQ(job.GetProgress(), 1);
+
+		// Registered after some tiles may have been finished already.
+		ASSERT_LE(tilesDone, 6);
+	}
+
+	TEST(RenderJobTest, CallsBackForEveryTile)
+	{
+		ThreadPool pool(2);
+		std::atomic<bool> isStarted = false;
+		RenderJob job = RenderJob::Start(Canvas(20, 20), Region{0, 0, 20, 20}.Tiles(5),
+		                                 [&](const Region& region, Canvas& image)
+		                                 {
+			                                 while (!isStarted) { std::this_thread::yield(); }
+			                                 image.SetPixel(region.X, region.Y, Colour::White);
+		                                 }, pool);
+
+		std::atomic<int> tilesDone = 0;
+		job.OnTileDone([&](const Region& tile)
+		{
+			ASSERT_EQ(tile.Width, 5);
+			++tilesDone;
+		});
+		ASSERT_EQ(job.GetProgress(), 0);
+		isStarted = true;
+
+		const Canvas& image = job.Wait();
+		ASSERT_EQ(tilesDone, 16);
+		ASSERT_EQ(image.GetPixel(0, 4), Colour::White);
+		ASSERT_EQ(image.GetPixel(15, 19), Colour::White);
+	}
+
+	TEST(RenderJobTest, Cancel)
+	{
+		ThreadPool pool(2);
+		std::atomic<int> rows = 0;
+		RenderJob job = RenderJob::Start(Canvas(64, 64), Region{0, 0, 64, 64}.Tiles(16),
+		                                 [&](const Region&, Canvas&)
+		                                 {
+			                                 ++rows;
+			                                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		                                 }, pool);
+
+		while (rows == 0) { std::this_thread::yield(); }
+		job.Cancel();
+
+		// Stops within a row on each worker, rather than finishing the tiles they're on.
+		ASSERT_TRUE(job.WaitFor(std::chrono::milliseconds(100)));
+		ASSERT_TRUE(job.IsCancelled());
+		ASSERT_LT(job.GetProgress(), 1);
+		ASSERT_LT(rows, 64);
+	}
+
+	TEST(RenderJobTest, RethrowsFromWait)
+	{
+		ThreadPool pool(2);
+		RenderJob job = RenderJob::Start(Canvas(8, 8), Region{0, 0, 8, 8}.Tiles(4),
+		                                 [](const Region&, Canvas&) { throw std::runtime_error("Failed"); }, pool);
+
+		ASSERT_THROW(job.Wait(), std::runtime_error);
+		ASSERT_TRUE(job.IsCancelled());
+	}
+}
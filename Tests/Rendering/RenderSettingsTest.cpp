@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <numbers>
+#include <sstream>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	World ReflectiveFloorWorld(float reflectiveness)
+	{
+		World world = World::ExampleWorld();
+		Shape* plane = &world.Add<Plane>();
+		world.SetMaterial(*plane, Material{.Reflectiveness = reflectiveness});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
+		return world;
+	}
+
+	TEST(RenderSettingsTest, ReflectionWeight)
+	{
+		RenderSettings settings{2, 0.1f};
+
+		float throughput = 0.5f;
+		ASSERT_EQ(settings.ReflectionWeight(throughput, Tuple::Point(0, 0, 0), 0), 1);
+		ASSERT_EQ(settings.ReflectionWeight(throughput, Tuple::Point(0, 0, 0), 2), 0);
+
+		throughput = 0.05f;
+		ASSERT_EQ(settings.ReflectionWeight(throughput, Tuple::Point(0, 0, 0), 0), 0);
+	}
+
+	TEST(RenderSettingsTest, RussianRouletteWeightsSurvivors)
+	{
+		RenderSettings settings{4, 0.5f, true};
+
+		// On average the weight of a reflection with a quarter of the minimum throughput should come to 1.
+		float totalWeight = 0;
+		int survivors = 0;
+		constexpr int Samples = 10000;
+		for (int i = 0; i < Samples; ++i)
+		{
+			float throughput = 0.125f;
+			float weight = settings.ReflectionWeight(throughput, Tuple::Point(i * 0.001f, 0, 0), 1);
+			totalWeight += weight;
+			if (weight > 0)
+			{
+				++survivors;
+				ASSERT_FLOAT_EQ(weight, 4);
+				ASSERT_FLOAT_EQ(throughput, 0.5f);
+			}
+		}
+
+		ASSERT_NEAR(totalWeight / Samples, 1, 0.05);
+		ASSERT_NEAR(static_cast<float>(survivors) / Samples, 0.25, 0.02);
+	}
+
+	TEST(RenderSettingsTest, MinThroughputStopsReflection)
+	{
+		World world = ReflectiveFloorWorld(0.5f);
+		Ray ray{Tuple::Point(0, 0, -3), Tuple::Vector(0, -std::sqrtf(2) / 2, std::sqrtf(2) / 2)};
+		Shape::Computation computation = Shape::Intersection{std::sqrtf(2), world.Objects[2]}
+			.PrepareComputations(ray);
+
+		ASSERT_NE(world.ReflectedColour(computation, RenderSettings{4, 0.4f}), Colour::Black);
+		ASSERT_EQ(world.ReflectedColour(computation, RenderSettings{4, 0.6f}), Colour::Black);
+		ASSERT_EQ(world.ReflectedColour(computation, RenderSettings{0}), Colour::Black);
+	}
+
+	TEST(RenderSettingsTest, WavefrontMatchesRender)
+	{
+		World world = ReflectiveFloorWorld(0.3f);
+
+		Camera camera{16, 12, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+		camera.Settings = {3, 0.2f, true};
+
+		ASSERT_EQ(camera.RenderWavefront(world).GetPixels(), camera.Render(world).GetPixels());
+	}
+
+	TEST(RenderSettingsTest, WrittenWithScene)
+	{
+		Camera camera{16, 12, std::numbers::pi / 2};
+		camera.Settings = {3, 0.2f, true};
+
+		std::stringstream stream;
+		Scene{World::ExampleWorld(), camera}.Write(stream);
+		ASSERT_EQ(Scene::Read(stream).Camera_.Settings, camera.Settings);
+	}
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include <numbers>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(RenderStatisticsTest, CountsRaysAndIntersectionTests)
+	{
+		World world = World::ExampleWorld();
+		RenderStatistics::CollectionScope collecting;
+		RenderStatistics& statistics = RenderStatistics::ThisThread();
+
+		// A hit also traces a shadow ray, each ray testing both spheres.
+		statistics.Reset();
+		world.ColourAt(Ray{Tuple::Point(0, 0, -5), Tuple::Vector(0, 0, 1)});
+		ASSERT_EQ(statistics.Rays, 2);
+		ASSERT_EQ(statistics.IntersectionTests, 4);
+		ASSERT_EQ(statistics.MaxDepth, 0);
+
+		statistics.Reset();
+		world.ColourAt(Ray{Tuple::Point(0, 0, -5), Tuple::Vector(0, 1, 0)});
+		ASSERT_EQ(statistics.Rays, 1);
+		ASSERT_EQ(statistics.IntersectionTests, 2);
+		ASSERT_EQ(statistics.Get(HeatmapMetric::Rays), 1);
+		ASSERT_EQ(statistics.Get(HeatmapMetric::IntersectionTests), 2);
+	}
+
+	TEST(RenderStatisticsTest, CountsReflectionDepth)
+	{
+		World world = World::ExampleWorld();
+		Shape* plane = &world.Add<Plane>();
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
+
+		// Bounces off the floor into the sky.
+		RenderStatistics::CollectionScope collecting;
+		RenderStatistics& statistics = RenderStatistics::ThisThread();
+		statistics.Reset();
+		constexpr float Diagonal = std::numbers::sqrt2 / 2;
+		world.ColourAt(Ray{Tuple::Point(0, 0, -3), Tuple::Vector(0, -Diagonal, Diagonal)});
+		ASSERT_EQ(statistics.MaxDepth, 1);
+		ASSERT_EQ(statistics.Get(HeatmapMetric::Depth), 1);
+	}
+
+	TEST(RenderStatisticsTest, OnlyCountedWhileCollecting)
+	{
+		World world = World::ExampleWorld();
+		RenderStatistics& statistics = RenderStatistics::ThisThread();
+		statistics.Reset();
+		world.ColourAt(Ray{Tuple::Point(0, 0, -5), Tuple::Vector(0, 0, 1)});
+		ASSERT_FALSE(RenderStatistics::IsCollecting());
+		ASSERT_EQ(statistics.Rays, 0);
+		ASSERT_EQ(statistics.IntersectionTests, 0);
+
+		{
+			RenderStatistics::CollectionScope outer;
+			{
+				RenderStatistics::CollectionScope inner;
+			}
+			ASSERT_TRUE(RenderStatistics::IsCollecting());
+			world.ColourAt(Ray{Tuple::Point(0, 0, -5), Tuple::Vector(0, 0, 1)});
+			ASSERT_EQ(statistics.Rays, 2);
+		}
+		ASSERT_FALSE(RenderStatistics::IsCollecting());
+	}
+
+	TEST(RenderStatisticsTest, HeatmapColourRamp)
+	{
+		ASSERT_EQ(Camera::HeatmapColour(0), Tuple::Colour(0, 0, 1));
+		ASSERT_EQ(Camera::HeatmapColour(0.5f), Tuple::Colour(0, 1, 0));
+		ASSERT_EQ(Camera::HeatmapColour(1), Tuple::Colour(1, 0, 0));
+		ASSERT_EQ(Camera::HeatmapColour(2), Tuple::Colour(1, 0, 0));
+	}
+
+	TEST(RenderStatisticsTest, HeatmapOfRays)
+	{
+		World world = World::ExampleWorld();
+		Camera camera{11, 11, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		Canvas heatmap = camera.RenderHeatmap(world, HeatmapMetric::Rays);
+
+		// Pixels that hit trace a shadow ray as well, twice as many as those that miss.
+		ASSERT_EQ(heatmap.GetPixel(5, 5), Tuple::Colour(1, 0, 0));
+		ASSERT_EQ(heatmap.GetPixel(0, 0), Tuple::Colour(0, 1, 0));
+
+		// Every pixel takes some time.
+		Canvas timings = camera.RenderHeatmap(world, HeatmapMetric::Nanoseconds);
+		for (const Tuple& pixel : timings.GetPixels()) { ASSERT_NE(pixel, Colour::Black); }
+	}
+}
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include <numbers>
+#include <sstream>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(SceneTest, RoundTrip)
+	{
+		World world = World::ExampleWorld();
+		Shape* plane = &world.Add<Plane>();
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
+		CheckerPattern* pattern = world.Make<CheckerPattern>(Colour::Red, Colour::Blue);
+		pattern->SetTransform(Matrix<4>::Scaling(0.25, 0.25, 0.25));
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f, .Pattern_ = pattern});
+
+		Camera camera{33, 17, std::numbers::pi / 3};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		std::stringstream stream;
+		Scene{world, camera}.Write(stream);
+		Scene scene = Scene::Read(stream);
+
+		ASSERT_EQ(scene.Camera_.RenderWidth, 33);
+		ASSERT_EQ(scene.Camera_.RenderHeight, 17);
+		ASSERT_EQ(scene.Camera_.Transform, camera.Transform);
+		ASSERT_EQ(scene.Camera_.PixelSize, camera.PixelSize);
+		ASSERT_EQ(scene.World_.Light, world.Light);
+		ASSERT_EQ(scene.World_.Objects.size(), 3);
+		ASSERT_NE(dynamic_cast<Sphere*>(scene.World_.Objects[0]), nullptr);
+		ASSERT_NE(dynamic_cast<Plane*>(scene.World_.Objects[2]), nullptr);
+		ASSERT_EQ(scene.World_.Objects[1]->GetTransform(), world.Objects[1]->GetTransform());
+		const World& read = scene.World_;
+		ASSERT_EQ(read.GetMaterial(*read.Objects[0]).Colour, world.GetMaterial(*world.Objects[0]).Colour);
+
+		auto* checker = dynamic_cast<const CheckerPattern*>(read.GetMaterial(*read.Objects[2]).Pattern_);
+		ASSERT_NE(checker, nullptr);
+		ASSERT_EQ(checker->ColourB, Colour::Blue);
+		ASSERT_EQ(checker->GetTransform(), pattern->GetTransform());
+
+		// Floats are written with enough precision that the render is identical.
+		ASSERT_EQ(scene.Camera_.Render(scene.World_).GetPixels(), camera.Render(world).GetPixels());
+	}
+
+	TEST(SceneTest, UnknownItem)
+	{
+		std::stringstream stream("camera 1 1 1 1 1 2 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\ncube");
+		ASSERT_THROW(Scene::Read(stream), std::runtime_error);
+	}
+}
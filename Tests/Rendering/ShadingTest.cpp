@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(ShadingTest, IntegerPower)
+	{
+		ASSERT_FLOAT_EQ(IntegerPower(0.9f, 0), 1);
+		ASSERT_FLOAT_EQ(IntegerPower(0.9f, 1), 0.9f);
+		ASSERT_NEAR(IntegerPower(0.9f, 200) / std::pow(0.9f, 200.0f), 1, 1e-4);
+		ASSERT_FLOAT_EQ(IntegerPower(2, 10), 1024);
+	}
+
+	TEST(ShadingTest, KernelsMatchMaterialLighting)
+	{
+		PointLight light{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
+		std::vector<Material> materials(6);
+		materials[1].Specular = 0;
+		materials[2].Diffuse = 0;
+		materials[2].Specular = 0;
+		materials[3].Shininess = 10.5f;
+		StripePattern stripes(Colour::White, Colour::Black);
+		materials[4].Pattern_ = &stripes;
+		materials[5].Colour = Tuple::Colour(0.8, 1.0, 0.6);
+		materials[5].Shininess = 1;
+
+		// Rays from around the sphere, so that some see it lit and some the side facing away from the light.
+		std::vector<Ray> rays
+		{
+			{Tuple::Point(0, 0, -5), Tuple::Vector(0, 0, 1)},
+			{Tuple::Point(-5, 5, -5), Tuple::Vector(1, -1, 1).Normalised()},
+			{Tuple::Point(5, 0, 0), Tuple::Vector(-1, 0, 0)},
+			{Tuple::Point(0.3, 0.2, -5), Tuple::Vector(0, 0, 1)},
+		};
+
+		for (const Material& material : materials)
+		{
+			Sphere sphere;
+			for (const Ray& ray : rays)
+			{
+				std::optional<Shape::Intersection> hit = Shape::Intersection::Hit(sphere.Intersect(ray));
+				ASSERT_TRUE(hit);
+				Shape::Computation computation = hit->PrepareComputations(ray);
+
+				for (bool inShadow : {false, true})
+				{
+					Tuple expected = sphere.Lighting(material, light, computation.Hit, computation.EyeVector,
+					                                 computation.Normal, inShadow);
+					Tuple result = SelectShadingKernel(material)(material, sphere, light, computation, inShadow);
+					ASSERT_EQ(result, expected);
+				}
+			}
+		}
+	}
+
+	TEST(ShadingTest, KernelChosenByMaterial)
+	{
+		Material specular;
+		Material matte;
+		matte.Specular = 0;
+		ASSERT_NE(SelectShadingKernel(specular), SelectShadingKernel(matte));
+		ASSERT_EQ(SelectShadingKernel(matte), SelectShadingKernel(matte));
+	}
+}
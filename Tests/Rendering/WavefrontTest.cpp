@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+#include <numbers>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(WavefrontTest, MatchesRender)
+	{
+		World world = World::ExampleWorld();
+
+		Camera camera{11, 11, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 0, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		Canvas expected = camera.Render(world);
+		Canvas image = camera.RenderWavefront(world);
+		ASSERT_EQ(image.GetPixel(5, 5), Tuple::Colour(0.38066, 0.47583, 0.2855));
+		ASSERT_EQ(image.GetPixels(), expected.GetPixels());
+	}
+
+	TEST(WavefrontTest, MatchesRenderWithReflections)
+	{
+		World world = World::ExampleWorld();
+		Shape* plane = &world.Add<Plane>();
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
+
+		Camera camera{16, 12, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		Canvas expected = camera.Render(world);
+		ASSERT_EQ(camera.RenderWavefront(world).GetPixels(), expected.GetPixels());
+		ASSERT_EQ(camera.RenderWavefront(world, 5).GetPixels(), expected.GetPixels());
+	}
+
+	TEST(WavefrontTest, ReflectionThroughput)
+	{
+		World world = World::ExampleWorld();
+		Shape* plane = &world.Add<Plane>();
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
+
+		Ray ray{Tuple::Point(0, 0, -3), Tuple::Vector(0, -std::sqrtf(2) / 2, std::sqrtf(2) / 2)};
+
+		Canvas image(1, 1);
+		Wavefront(world).Trace({{ray, 0, 0}}, image);
+		ASSERT_EQ(image.GetPixel(0, 0), world.ColourAt(ray));
+	}
+
+	TEST(WavefrontTest, MatchesRenderWithManyMaterials)
+	{
+		World world = World::ExampleWorld();
+		for (int i = 0; i < 6; ++i)
+		{
+			Shape* sphere = &world.Add<Sphere>();
+			sphere->SetTransform(Matrix<4>::Scaling(0.3, 0.3, 0.3).Translate(-1.5 + 0.6 * i, 1.2, -1));
+			Material material{.Colour = Tuple::Colour(0.2 * (i % 3), 0.5, 1 - 0.2 * (i % 3))};
+			material.Specular = (i % 2) ? 0 : 0.9f;
+			material.Reflectiveness = (i % 4 == 0) ? 0.3f : 0;
+			world.SetMaterial(*sphere, material);
+		}
+		Material patterned = world.GetMaterial(*world.Objects[2]);
+		patterned.Pattern_ = world.Make<CheckerPattern>(Colour::White, Colour::Blue);
+		world.SetMaterial(*world.Objects[2], patterned);
+
+		Camera camera{24, 16, std::numbers::pi / 2};
+		camera.Transform = Matrix<4>::ViewTransform(Tuple::Point(0, 1, -5), Tuple::Point(0, 0.5, 0),
+		                                            Tuple::Vector(0, 1, 0));
+
+		Canvas expected = camera.Render(world);
+		ASSERT_EQ(camera.RenderWavefront(world).GetPixels(), expected.GetPixels());
+	}
+}
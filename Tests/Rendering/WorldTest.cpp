@@ -17,17 +17,17 @@ namespace RayTracer
 		World world = World::ExampleWorld();
 		PointLight light{Tuple::Point(-10, 10, -10), Tuple::Colour(1, 1, 1)};
 
-		Sphere& sphere0 = static_cast<Sphere&>(*world.Objects[0].get());
-		Sphere& sphere1 = static_cast<Sphere&>(*world.Objects[1].get());
+		Sphere& sphere0 = static_cast<Sphere&>(*world.Objects[0]);
+		Sphere& sphere1 = static_cast<Sphere&>(*world.Objects[1]);
 
 		Material material{Tuple::Colour(0.8, 1.0, 0.6)};
 		material.Diffuse = 0.7;
 		material.Specular = 0.2;
 
 		ASSERT_EQ(world.Light, light);
-		ASSERT_EQ(sphere0.Transform_, Matrix<4>::IdentityMatrix());
-		ASSERT_EQ(sphere0.Material_, material);
-		ASSERT_EQ(sphere1.Transform_, Matrix<4>::Scaling(0.5, 0.5, 0.5));
+		ASSERT_EQ(sphere0.GetTransform(), Matrix<4>::IdentityMatrix());
+		ASSERT_EQ(world.GetMaterial(sphere0), material);
+		ASSERT_EQ(sphere1.GetTransform(), Matrix<4>::Scaling(0.5, 0.5, 0.5));
 	}
 
 	TEST(WorldTest, WorldIntersect)
@@ -48,8 +48,8 @@ namespace RayTracer
 		World world = World::ExampleWorld();
 		world.Light = PointLight{Tuple::Point(0, 0.25, 0), Tuple::Colour(1, 1, 1)};
 		Ray ray{Tuple::Point(0, 0, 0), Tuple::Vector(0, 0, 1)};
-		auto& object = world.Objects[1];
-		Shape::Intersection intersection{0.5, object.get()};
+		Shape* object = world.Objects[1];
+		Shape::Intersection intersection{0.5, object};
 		auto computation = intersection.PrepareComputations(ray);
 		Tuple resultingColour = world.ShadeIntersection(computation);
 		ASSERT_EQ(resultingColour, Tuple::Colour(0.1, 0.1, 0.1));
@@ -72,14 +72,18 @@ namespace RayTracer
 	TEST(WorldTest, IntersectionBehindRay)
 	{
 		World world = World::ExampleWorld();
-		auto& outer = world.Objects[0];
-		auto& inner = world.Objects[1];
-
-		outer->Material_.Ambient = 1;
-		inner->Material_.Ambient = 1;
+		Shape* outer = world.Objects[0];
+		Shape* inner = world.Objects[1];
+
+		for (Shape* object : {outer, inner})
+		{
+			Material material = world.GetMaterial(*object);
+			material.Ambient = 1;
+			world.SetMaterial(*object, material);
+		}
 		Ray ray{Tuple::Point(0, 0, 0.75), Tuple::Vector(0, 0, -1)};
 		Tuple colour = world.ColourAt(ray);
-		ASSERT_EQ(colour, inner->Material_.Colour);
+		ASSERT_EQ(colour, world.GetMaterial(*inner).Colour);
 	}
 
 	TEST(WorldTest, PointNonOccluded)
@@ -114,11 +118,11 @@ namespace RayTracer
 	{
 		World world = World::ExampleWorld();
 		world.Light = PointLight{Tuple::Point(0, 0, -10), Tuple::Colour(1, 1, 1)};
-		Sphere& sphere0 = static_cast<Sphere&>(*world.Objects[0].get());
-		sphere0.Transform_ = Matrix<4>::IdentityMatrix().Translated(0, 0, 10);
+		Sphere& sphere0 = static_cast<Sphere&>(*world.Objects[0]);
+		sphere0.SetTransform(Matrix<4>::IdentityMatrix().Translated(0, 0, 10));
 
-		Sphere& sphere1 = static_cast<Sphere&>(*world.Objects[1].get());
-		sphere1.Transform_ = Matrix<4>::IdentityMatrix();
+		Sphere& sphere1 = static_cast<Sphere&>(*world.Objects[1]);
+		sphere1.SetTransform(Matrix<4>::IdentityMatrix());
 
 		Ray ray{Tuple::Point(0, 0, 5), Tuple::Vector(0, 0, 1)};
 
@@ -135,8 +139,8 @@ namespace RayTracer
 
 		Ray ray{Tuple::Point(0, 0, 0), Tuple::Vector(0, 0, 1)};
 
-		Shape& shape = *world.Objects[1].get();
-		shape.Material_.Ambient = 1;
+		Shape& shape = *world.Objects[1];
+		world.SetMaterial(shape, Material{.Ambient = 1});
 
 		Shape::Intersection intersection{1, &shape};
 
@@ -150,11 +154,11 @@ namespace RayTracer
 	TEST(WorldTest, ReflectiveMaterial)
 	{
 		World world = World::ExampleWorld();
-		world.Objects.emplace_back(std::make_shared<Plane>());
+		world.Add<Plane>();
 
-		Shape* plane = world.Objects[2].get();
-		plane->Material_.Reflectiveness = 0.5f;
-		plane->Transform_.Translate(0, -1, 0);
+		Shape* plane = world.Objects[2];
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
 
 		Ray ray{Tuple::Point(0, 0, -3), Tuple::Vector(0, -std::sqrtf(2) / 2, std::sqrtf(2) / 2)};
 
@@ -170,11 +174,11 @@ namespace RayTracer
 	TEST(WorldTest, ReflectiveMaterialShade)
 	{
 		World world = World::ExampleWorld();
-		world.Objects.emplace_back(std::make_shared<Plane>());
+		world.Add<Plane>();
 
-		Shape* plane = world.Objects[2].get();
-		plane->Material_.Reflectiveness = 0.5f;
-		plane->Transform_.Translate(0, -1, 0);
+		Shape* plane = world.Objects[2];
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
 
 		Ray ray{Tuple::Point(0, 0, -3), Tuple::Vector(0, -std::sqrtf(2) / 2, std::sqrtf(2) / 2)};
 
@@ -191,17 +195,17 @@ namespace RayTracer
 	{
 		World world;
 		world.Light = PointLight{Tuple::Point(0, 0, 0), Colour::White};
-		world.Objects.emplace_back(std::make_shared<Plane>());
-		world.Objects.emplace_back(std::make_shared<Plane>());
+		world.Add<Plane>();
+		world.Add<Plane>();
 
-		Shape& lower = *world.Objects[0].get();
-		lower.Material_.Reflectiveness = 1;
-		lower.Transform_.Translate(0, -1, 0);
+		Shape& lower = *world.Objects[0];
+		world.SetMaterial(lower, Material{.Reflectiveness = 1});
+		lower.SetTransform(Matrix<4>::Translation(0, -1, 0));
 
 		// Why do I need to rotate this?
-		Shape& upper = *world.Objects[1].get();
-		upper.Material_.Reflectiveness = 1;
-		upper.Transform_.RotateX(-std::numbers::pi).Translate(0, 1, 0);
+		Shape& upper = *world.Objects[1];
+		world.SetMaterial(upper, Material{.Reflectiveness = 1});
+		upper.SetTransform(Matrix<4>::RotationX(-std::numbers::pi).Translate(0, 1, 0));
 
 		Ray ray{Tuple::Point(0, 0, 0), Tuple::Vector(0, 1, 0)};
 
@@ -213,12 +217,12 @@ namespace RayTracer
 	TEST(WorldTest, ReflectionMaximumDepth)
 	{
 		World world = World::ExampleWorld();
-		std::shared_ptr<Shape>& plane = world.Objects.emplace_back(std::make_shared<Plane>());
-		plane->Material_.Reflectiveness = 0.5;
-		plane->Transform_.Translate(0, -1, 0);
+		Shape* plane = &world.Add<Plane>();
+		world.SetMaterial(*plane, Material{.Reflectiveness = 0.5f});
+		plane->SetTransform(Matrix<4>::Translation(0, -1, 0));
 
 		Ray ray{Tuple::Point(0, 0, -3), Tuple::Vector(0, -std::sqrtf(2) / 2.f, std::sqrtf(2) / 2.f)};
-		Shape::Intersection intersection{std::sqrtf(2), plane.get()};
+		Shape::Intersection intersection{std::sqrtf(2), plane};
 
 		Shape::Computation computation = intersection.PrepareComputations(ray);
 		Tuple colour = world.ReflectedColour(computation, 0);
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+
+import RayTracer;
+
+namespace RayTracer
+{
+	namespace
+	{
+		// A grid of small spheres above a floor.
+		World SphereGrid()
+		{
+			World world;
+			world.Light = PointLight{Tuple::Point(-10, 10, -10), Colour::White};
+			world.Add<Plane>(Matrix<4>::Translation(0, -1, 0));
+			for (int x = -5; x <= 5; ++x)
+			{
+				for (int z = -5; z <= 5; ++z)
+				{
+					world.Add<Sphere>(Matrix<4>::Scaling(0.3, 0.3, 0.3).Translated(x, 0, z));
+				}
+			}
+
+			return world;
+		}
+	}
+
+	TEST(BVHTest, Structure)
+	{
+		World world = SphereGrid();
+		world.BuildAccelerationStructure();
+
+		const std::vector<BVH::Node>& nodes = world.Acceleration.GetNodes();
+		ASSERT_FALSE(nodes.empty());
+		ASSERT_TRUE(world.Acceleration.IsBuiltFor(world.Objects));
+		ASSERT_EQ(nodes[0].Bounds_.Min, Tuple::Point(-5.3, -0.3, -5.3));
+		ASSERT_EQ(nodes[0].Bounds_.Max, Tuple::Point(5.3, 0.3, 5.3));
+
+		int shapes = 0;
+		for (const BVH::Node& node : nodes)
+		{
+			if (node.IsLeaf())
+			{
+				ASSERT_LE(node.ShapeCount, BVH::MaxLeafSize);
+				shapes += node.ShapeCount;
+			}
+		}
+		ASSERT_EQ(shapes, 121);
+	}
+
+	TEST(BVHTest, MatchesBruteForce)
+	{
+		World bruteForce = SphereGrid();
+		World accelerated = bruteForce;
+		accelerated.BuildAccelerationStructure();
+
+		for (float x = -6; x <= 6; x += 0.37f)
+		{
+			Ray ray{Tuple::Point(x, 3, -8), Tuple::Vector(0.1, -0.4, 1).Normalised()};
+			ASSERT_EQ(accelerated.ColourAt(ray), bruteForce.ColourAt(ray));
+
+			std::optional<Shape::Intersection> expected = Shape::Intersection::Hit(bruteForce.Intersect(ray));
+			std::optional<Shape::Intersection> hit = Shape::Intersection::Hit(accelerated.Intersect(ray));
+			ASSERT_EQ(hit.has_value(), expected.has_value());
+			if (hit) { ASSERT_EQ(*hit, *expected); }
+		}
+	}
+
+	TEST(BVHTest, SkipsMissedBoxes)
+	{
+		World world = SphereGrid();
+		world.BuildAccelerationStructure();
+
+		int visited = 0;
+		world.Acceleration.ForEachCandidate({Tuple::Point(0, 0, -10), Tuple::Vector(0, 0, 1)},
+		                                    [&](Shape&) { ++visited; });
+		ASSERT_LT(visited, 40);
+	}
+
+	TEST(BVHTest, Refit)
+	{
+		World world = SphereGrid();
+		world.BuildAccelerationStructure();
+
+		Ray ray{Tuple::Point(0, 10, -20), Tuple::Vector(0, 0, 1)};
+		ASSERT_FALSE(Shape::Intersection::Hit(world.Intersect(ray)));
+
+		// Without refitting, the moved sphere is still in its old box and the ray misses it.
+		Shape& moved = *world.Objects[1];
+		moved.SetTransform(Matrix<4>::Translation(0, 10, 0));
+		world.RefitAccelerationStructure();
+
+		std::optional<Shape::Intersection> hit = Shape::Intersection::Hit(world.Intersect(ray));
+		ASSERT_TRUE(hit);
+		ASSERT_EQ(*hit->Object, moved);
+		ASSERT_EQ(world.Acceleration.GetNodes()[0].Bounds_.Max, Tuple::Point(5.3, 11, 5.3));
+	}
+
+	TEST(BVHTest, RefitOnlyMoved)
+	{
+		World world = SphereGrid();
+		world.BuildAccelerationStructure();
+
+		// Only the shapes said to have moved have their bounds worked out again.
+		Shape* moved = world.Objects[1];
+		moved->SetTransform(Matrix<4>::Translation(0, 10, 0));
+		world.Objects[2]->SetTransform(Matrix<4>::Translation(0, 20, 0));
+		world.RefitAccelerationStructure({&moved, 1});
+
+		ASSERT_EQ(world.Acceleration.GetNodes()[0].Bounds_.Max, Tuple::Point(5.3, 11, 5.3));
+	}
+
+	TEST(BVHTest, IgnoredWhenObjectsChange)
+	{
+		World world = SphereGrid();
+		world.BuildAccelerationStructure();
+		world.Add<Sphere>(Matrix<4>::Translation(0, 10, 0));
+
+		ASSERT_FALSE(world.Acceleration.IsBuiltFor(world.Objects));
+		Ray ray{Tuple::Point(0, 10, -20), Tuple::Vector(0, 0, 1)};
+		ASSERT_TRUE(Shape::Intersection::Hit(world.Intersect(ray)));
+	}
+
+	TEST(BVHTest, ReplacedObjectsAreNotUsed)
+	{
+		World world = SphereGrid();
+		world.BuildAccelerationStructure();
+
+		// Same number of objects, but one is now a different shape somewhere else.
+		world.Objects[1] = world.Make<Sphere>(Matrix<4>::Translation(0, 10, 0));
+		ASSERT_FALSE(world.Acceleration.IsBuiltFor(world.Objects));
+
+		world.Prepare();
+		Ray ray{Tuple::Point(0, 10, -20), Tuple::Vector(0, 0, 1)};
+		std::optional<Shape::Intersection> hit = Shape::Intersection::Hit(world.Intersect(ray));
+		ASSERT_TRUE(hit);
+		ASSERT_EQ(hit->Object, world.Objects[1]);
+
+		world.BuildAccelerationStructure();
+		ASSERT_TRUE(Shape::Intersection::Hit(world.Intersect(ray)));
+	}
+}
@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include <numbers>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(BoundsTest, EmptyByDefault)
+	{
+		Bounds bounds;
+		ASSERT_TRUE(bounds.IsEmpty());
+		ASSERT_TRUE(Bounds::Empty().IsEmpty());
+		ASSERT_FALSE(Bounds::Unbounded().IsFinite());
+	}
+
+	TEST(BoundsTest, Extend)
+	{
+		Bounds bounds;
+		bounds.Extend(Tuple::Point(-5, 2, 0));
+		bounds.Extend(Tuple::Point(7, 0, -3));
+		ASSERT_EQ(bounds.Min, Tuple::Point(-5, 0, -3));
+		ASSERT_EQ(bounds.Max, Tuple::Point(7, 2, 0));
+		ASSERT_EQ(bounds.Centre(), Tuple::Point(1, 1, -1.5));
+	}
+
+	TEST(BoundsTest, SphereBounds)
+	{
+		Sphere sphere;
+		sphere.SetTransform(Matrix<4>::Scaling(2, 2, 2).Translated(1, 0, 0));
+		ASSERT_EQ(sphere.WorldBounds().Min, Tuple::Point(-1, -2, -2));
+		ASSERT_EQ(sphere.WorldBounds().Max, Tuple::Point(3, 2, 2));
+
+		// Nothing to update after moving the shape, as setting the transform keeps everything in step.
+		sphere.SetTransform(Matrix<4>::Translation(0, 5, 0));
+		ASSERT_EQ(sphere.WorldBounds().Max, Tuple::Point(1, 6, 1));
+		ASSERT_EQ(sphere.InverseTransform().TransformPoint(Tuple::Point(0, 5, 0)), Tuple::Point(0, 0, 0));
+	}
+
+	TEST(BoundsTest, RotatedBounds)
+	{
+		Bounds bounds{Tuple::Point(-1, -1, -1), Tuple::Point(1, 1, 1)};
+		Bounds rotated = bounds.Transformed(Matrix<4>::RotationY(std::numbers::pi / 4));
+		ASSERT_EQ(rotated.Min, Tuple::Point(-std::sqrtf(2), -1, -std::sqrtf(2)));
+		ASSERT_EQ(rotated.Max, Tuple::Point(std::sqrtf(2), 1, std::sqrtf(2)));
+	}
+
+	TEST(BoundsTest, PlaneIsUnbounded)
+	{
+		Plane plane;
+		ASSERT_FALSE(plane.WorldBounds().IsFinite());
+	}
+
+	TEST(BoundsTest, RayIntersection)
+	{
+		Bounds bounds{Tuple::Point(-1, -1, -1), Tuple::Point(1, 1, 1)};
+		ASSERT_TRUE(bounds.Intersects({Tuple::Point(0, 0, -5), Tuple::Vector(0, 0, 1)}));
+		ASSERT_TRUE(bounds.Intersects({Tuple::Point(0, 0, 0), Tuple::Vector(0, 0, 1)}));
+		ASSERT_FALSE(bounds.Intersects({Tuple::Point(0, 2, -5), Tuple::Vector(0, 0, 1)}));
+		ASSERT_FALSE(bounds.Intersects({Tuple::Point(0, 0, 5), Tuple::Vector(0, 0, 1)}));
+		ASSERT_FALSE(bounds.Intersects({Tuple::Point(0, 0, -5), Tuple::Vector(0, 0, 1)}, 3));
+		ASSERT_TRUE(bounds.Intersects({Tuple::Point(-5, 0.5, 0.5), Tuple::Vector(1, 0, 0)}));
+	}
+}
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	struct Counted
+	{
+		int& Destroyed;
+
+		~Counted() { ++Destroyed; }
+	};
+
+	struct alignas(64) Aligned
+	{
+		float Value;
+	};
+
+	TEST(ArenaTest, ObjectsAreNextToEachOther)
+	{
+		Arena arena;
+		Sphere* first = arena.Make<Sphere>();
+		Sphere* second = arena.Make<Sphere>();
+
+		ASSERT_EQ(reinterpret_cast<std::byte*>(second) - reinterpret_cast<std::byte*>(first), sizeof(Sphere));
+		ASSERT_EQ(arena.GetBlockCount(), 1);
+	}
+
+	TEST(ArenaTest, ObjectsDestroyedWithArena)
+	{
+		int destroyed = 0;
+		{
+			Arena arena;
+			arena.Make<Counted>(destroyed);
+			arena.Make<Counted>(destroyed);
+			ASSERT_EQ(destroyed, 0);
+		}
+
+		ASSERT_EQ(destroyed, 2);
+	}
+
+	TEST(ArenaTest, Alignment)
+	{
+		Arena arena;
+		arena.Make<char>('a');
+		Aligned* aligned = arena.Make<Aligned>();
+
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+	}
+
+	TEST(ArenaTest, NewBlockWhenFull)
+	{
+		Arena arena(256);
+		for (int i = 0; i < 100; ++i) { arena.Make<float>(static_cast<float>(i)); }
+		ASSERT_GT(arena.GetBlockCount(), 1);
+
+		// Too big for a block of its own size.
+		arena.Make<std::array<float, 1024>>();
+		ASSERT_GE(arena.GetBytesReserved(), arena.GetBytesUsed());
+	}
+
+	TEST(ArenaTest, SceneReadIntoWorldStorage)
+	{
+		std::stringstream stream;
+		Scene{World::ExampleWorld(), {11, 11, 1}}.Write(stream);
+		Scene scene = Scene::Read(stream);
+
+		const Shape* first = scene.World_.Objects.front();
+		const Shape* last = scene.World_.Objects.back();
+		ASSERT_EQ(reinterpret_cast<const std::byte*>(last) - reinterpret_cast<const std::byte*>(first),
+		          sizeof(Sphere));
+		ASSERT_EQ(scene.World_.Storage->GetBlockCount(), 1);
+	}
+
+	TEST(ArenaTest, SceneWithPatternsIsFreed)
+	{
+		World world = World::ExampleWorld();
+		world.SetMaterial(*world.Objects.front(),
+		                  Material{.Pattern_ = world.Make<StripePattern>(Colour::White, Colour::Black)});
+
+		std::stringstream stream;
+		Scene{world, {11, 11, 1}}.Write(stream);
+		std::weak_ptr<Arena> storage;
+		{
+			Scene scene = Scene::Read(stream);
+			ASSERT_NE(scene.World_.GetMaterial(*scene.World_.Objects.front()).Pattern_, nullptr);
+			storage = scene.World_.Storage;
+		}
+
+		ASSERT_TRUE(storage.expired());
+	}
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <sstream>
+#include <utility>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(MemoryTest, TrackedBytes)
+	{
+		MemoryTracker::Enable();
+		size_t before = MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects);
+		{
+			TrackedBytes tracked(MemoryCategory::SceneObjects, 100);
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before + 100);
+
+			// Copies hold memory of their own, moves take it over.
+			TrackedBytes copy = tracked;
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before + 200);
+			TrackedBytes moved = std::move(copy);
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before + 200);
+
+			tracked.Set(50);
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before + 150);
+			ASSERT_GE(MemoryTracker::GetPeakBytes(MemoryCategory::SceneObjects), before + 200);
+		}
+		ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before);
+
+		// Nothing is counted while disabled, but what was counted is still taken away.
+		TrackedBytes tracked(MemoryCategory::SceneObjects, 100);
+		MemoryTracker::Disable();
+		TrackedBytes untracked(MemoryCategory::SceneObjects, 100);
+		ASSERT_EQ(untracked.GetBytes(), 0);
+		tracked.Set(0);
+		ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before);
+	}
+
+	TEST(MemoryTest, SceneObjectsCountedByArena)
+	{
+		MemoryTracker::Enable();
+		size_t before = MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects);
+		{
+			// Objects don't count themselves, so ones made outside an arena aren't counted.
+			Sphere sphere;
+			StripePattern pattern(Colour::White, Colour::Black);
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before);
+		}
+
+		{
+			// The arena counts whole blocks, so objects made in one it already has change nothing.
+			Arena arena;
+			arena.Make<Sphere>();
+			size_t withFirst = MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects);
+			ASSERT_GE(withFirst, before + Arena::DefaultBlockSize);
+			arena.Make<Sphere>();
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), withFirst);
+		}
+		ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::SceneObjects), before);
+
+		MemoryTracker::Disable();
+	}
+
+	TEST(MemoryTest, ThreadTrackedBytesCountedWhenFlushed)
+	{
+		MemoryTracker::Enable();
+		MemoryTracker::FlushThisThread();
+		size_t before = MemoryTracker::GetCurrentBytes(MemoryCategory::RayBuffers);
+		MemoryTracker::ResetPeaks();
+		{
+			ThreadTrackedBytes first(MemoryCategory::RayBuffers, 100);
+			{
+				ThreadTrackedBytes second(MemoryCategory::RayBuffers, 50);
+			}
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::RayBuffers), before);
+
+			MemoryTracker::FlushThisThread();
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::RayBuffers), before + 100);
+			ASSERT_EQ(MemoryTracker::GetPeakBytes(MemoryCategory::RayBuffers), before + 150);
+		}
+		MemoryTracker::FlushThisThread();
+		ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::RayBuffers), before);
+
+		MemoryTracker::Disable();
+	}
+
+	TEST(MemoryTest, RenderIsAttributed)
+	{
+		MemoryTracker::Enable();
+		size_t framebuffers = MemoryTracker::GetCurrentBytes(MemoryCategory::Framebuffers);
+		size_t rayBuffers = MemoryTracker::GetCurrentBytes(MemoryCategory::RayBuffers);
+		MemoryTracker::ResetPeaks();
+
+		World world = World::ExampleWorld();
+		world.BuildAccelerationStructure();
+		Camera camera(20, 10, 1);
+		{
+			Canvas image = camera.Render(world);
+			ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::Framebuffers), framebuffers + 200 * sizeof(Tuple));
+		}
+
+		ASSERT_GT(MemoryTracker::GetCurrentBytes(MemoryCategory::Acceleration), 0);
+		ASSERT_GT(MemoryTracker::GetPeakBytes(MemoryCategory::RayBuffers), rayBuffers);
+		ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::RayBuffers), rayBuffers);
+		ASSERT_EQ(MemoryTracker::GetCurrentBytes(MemoryCategory::Framebuffers), framebuffers);
+
+		std::stringstream report;
+		MemoryTracker::WriteReport(report);
+		ASSERT_NE(report.str().find("Framebuffers"), std::string::npos);
+		ASSERT_NE(report.str().find("Total"), std::string::npos);
+
+		MemoryTracker::Disable();
+	}
+}
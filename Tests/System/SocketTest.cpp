@@ -0,0 +1,50 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <thread>
+
+import RayTracer;
+
+#if !defined(_WIN32)
+namespace RayTracer
+{
+	TEST(SocketTest, UnixRoundTrip)
+	{
+		std::string address = Socket::UnixPrefix +
+			(std::filesystem::temp_directory_path() / "RayTracerSocketTest.sock").string();
+		Socket listener = Socket::Listen(address);
+
+		std::thread client([&address]
+		{
+			Socket socket = Socket::Connect(address);
+			socket.SendString("tile");
+			socket.SendValue(42);
+		});
+
+		Socket connection = listener.Accept();
+		std::string message;
+		int value = 0;
+		ASSERT_TRUE(connection.ReceiveString(message));
+		ASSERT_TRUE(connection.ReceiveValue(value));
+		client.join();
+
+		ASSERT_EQ(message, "tile");
+		ASSERT_EQ(value, 42);
+		ASSERT_FALSE(connection.ReceiveValue(value));
+	}
+
+	TEST(SocketTest, TCPRoundTrip)
+	{
+		Socket listener = Socket::Listen("127.0.0.1:47913");
+
+		std::thread client([] { Socket::Connect("127.0.0.1:47913").SendValue(7.5f); });
+
+		Socket connection = listener.Accept();
+		float value = 0;
+		ASSERT_TRUE(connection.ReceiveValue(value));
+		client.join();
+		ASSERT_EQ(value, 7.5f);
+	}
+
+	TEST(SocketTest, MissingPort) { ASSERT_THROW(Socket::Connect("localhost"), std::runtime_error); }
+}
+#endif
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce)
+	{
+		ThreadPool pool(4);
+		std::vector<std::atomic<int>> visits(1000);
+		pool.ParallelFor(visits.size(), [&](size_t i) { ++visits[i]; });
+
+		for (const std::atomic<int>& count : visits) { ASSERT_EQ(count, 1); }
+	}
+
+	TEST(ThreadPoolTest, NestedParallelFor)
+	{
+		ThreadPool pool(2);
+		std::atomic<int> total = 0;
+		pool.ParallelFor(8, [&](size_t) { pool.ParallelFor(8, [&](size_t) { ++total; }); });
+
+		ASSERT_EQ(total, 64);
+	}
+
+	TEST(ThreadPoolTest, ExceptionRethrown)
+	{
+		ThreadPool pool(2);
+		std::atomic<int> finished = 0;
+		auto task = [&](size_t i)
+		{
+			if (i == 3) { throw std::runtime_error("Tile failed"); }
+			++finished;
+		};
+
+		ASSERT_THROW(pool.ParallelFor(10, task), std::runtime_error);
+		ASSERT_EQ(finished, 9);
+	}
+
+	TEST(ThreadPoolTest, Submit)
+	{
+		std::atomic<int> ran = 0;
+		{
+			ThreadPool pool(3);
+			for (int i = 0; i < 20; ++i) { pool.Submit([&] { ++ran; }); }
+		}
+
+		ASSERT_EQ(ran, 20);
+	}
+}
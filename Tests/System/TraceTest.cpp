@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include <numbers>
+#include <sstream>
+#include <string>
+
+import RayTracer;
+
+namespace RayTracer
+{
+	TEST(TraceTest, NothingRecordedUnlessStarted)
+	{
+		Trace::Start();
+		Trace::Stop();
+		{
+			TraceScope trace("Ignored");
+		}
+
+		ASSERT_EQ(Trace::GetEventCount(), 0);
+	}
+
+	TEST(TraceTest, RenderRecordsTiles)
+	{
+		Camera camera{40, 20, std::numbers::pi / 2};
+		ThreadPool pool(2);
+
+		Trace::Start();
+		camera.Render(World::ExampleWorld(), pool);
+		Trace::Stop();
+
+		// One event for the render, one for preparing the world, and one for each of the 3 by 2 tiles.
+		ASSERT_EQ(Trace::GetEventCount(), 8);
+
+		std::stringstream stream;
+		Trace::WriteJSON(stream);
+		std::string json = stream.str();
+		ASSERT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+		ASSERT_NE(json.find("\"name\":\"Render\",\"ph\":\"X\""), std::string::npos);
+		ASSERT_NE(json.find("\"args\":{\"x\":32,\"y\":16,\"width\":8,\"height\":4}"), std::string::npos);
+		ASSERT_NE(json.find("\"name\":\"thread_name\""), std::string::npos);
+	}
+}